@@ -2,6 +2,8 @@
 
 #include "gameboy.h"
 
+void evaluate_flags(GameBoy *);
+
 uint8_t and (GameBoy *, uint8_t, uint8_t);
 uint8_t or (GameBoy *, uint8_t, uint8_t);
 uint8_t xor (GameBoy *, uint8_t, uint8_t);
@@ -5,6 +5,7 @@
 #define AUDIO_SAMPLES 1024
 #define AUDIO_CHANNELS 2
 #define SAMPLE_RATE 44100
+#define AUDIO_BUFFER_SIZE (AUDIO_SAMPLES * AUDIO_CHANNELS) // Floats handed out at once
 
 #define CHANNEL_SQUARE_1 0
 #define CHANNEL_SQUARE_2 1
@@ -96,8 +97,10 @@
 #define SND_1_ON 0x1
 
 void init_apu(GameBoy *);
+void free_apu(GameBoy *);
 void reset_apu(GameBoy *);
-void update_apu(GameBoy *);
+void update_frame_sequencer(GameBoy *, uint64_t);
+void update_audio_sample(GameBoy *, uint64_t);
 
 void audio_register_write(GameBoy *, uint16_t, uint8_t);
 uint8_t audio_register_read(GameBoy *, uint16_t, uint8_t);
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "gameboy.h"
+#include "mmu.h"
+#include "ppu.h"
+
+#define ARENA_ALIGNMENT 64
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+// Back the arena with huge pages when enabled, only where the kernel provides them
+#if defined(JGBC_HUGE_PAGES) && defined(__linux__)
+#define HUGE_PAGES
+#endif
+
+// All the emulated memory of a GameBoy in a fixed layout, a snapshot is a single copy
+// The largest regions come first so that each of them starts on a cache line
+struct Arena_s {
+    uint8_t extram[EXTRAM_BANK_COUNT][EXTRAM_BANK_SIZE];
+    uint8_t wram[WRAM_BANK_COUNT][WRAM_BANK_SIZE];
+    uint8_t vram[VRAM_BANK_COUNT][VRAM_BANK_SIZE];
+    uint16_t framebuffer[SCREEN_WIDTH * SCREEN_HEIGHT];
+    uint8_t io[IO_SIZE];
+    uint8_t hram[HRAM_SIZE];
+    uint8_t oam[OAM_SIZE];
+    Sprite sprite_buffer[SPRITES_PER_LINE];
+    uint8_t ier;
+};
+
+void init_arena(GameBoy *);
+void free_arena(GameBoy *);
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "cpu.h"
+#include "gameboy.h"
+
+#define BLOCK_CACHE_SIZE 4096
+
+// Run code from decoded basic blocks unless disabled
+#ifndef JGBC_NO_BLOCK_CACHE
+#define BLOCK_CACHE
+#endif
+
+#define CODE_MAP_START 0xC000
+
+void init_blocks(GameBoy *);
+void free_blocks(GameBoy *);
+void flush_blocks(GameBoy *);
+Block *find_block(GameBoy *);
+
+// Writing over cached code drops the decoded blocks, the echo of work RAM aliases it
+static inline void track_code_write(GameBoy *gb, uint16_t address) {
+    if (address < CODE_MAP_START) {
+        return;
+    }
+
+    if (address >= 0xE000 && address <= 0xFDFF) {
+        address -= 0x2000;
+    }
+
+    const uint16_t index = address - CODE_MAP_START;
+
+    if (gb->block_cache.code_map[index >> 3] & (1 << (index & 7))) {
+        flush_blocks(gb);
+    }
+}
+
+// The opcode has already been fetched, the fetches of the handler return the decoded operand
+static inline void begin_block_instruction(GameBoy *gb, const uint16_t operand) {
+    gb->cpu.ticks = CPU_STEP;
+    tick_timer(gb, CPU_STEP);
+    REG(PC)++;
+    gb->cpu.decoded_operand = operand;
+}
+
+// Same as the end of an instruction in the interpreter, false when the block has to stop here
+static inline bool end_block_instruction(GameBoy *gb, const uint16_t instr_start, const uint8_t length) {
+    gb->stats.instructions++;
+    gb->stats.block_instructions++;
+
+    if (REG(PC) < instr_start && instr_start - REG(PC) < IDLE_LOOP_MAX_LENGTH) {
+        check_idle_loop(gb, instr_start);
+    }
+
+    gb->scheduler.cycles += gb->cpu.ticks >> gb->cpu.is_double_speed;
+    check_interrupts(gb);
+
+    // Taken branches and serviced interrupts move PC elsewhere
+    return REG(PC) == (uint16_t) (instr_start + length) && gb->scheduler.cycles < gb->scheduler.deadline &&
+           !gb->cpu.is_halted && !gb->block_cache.is_stale;
+}
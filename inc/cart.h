@@ -16,8 +16,22 @@
 #define CART_HEADER_ROM_SIZE 0x148
 #define CART_HEADER_RAM_SIZE 0x149
 
+// Appended to the rom path for the file holding the cart ram
+#define SAVE_EXTENSION ".save"
+
+// The rom file is memory mapped where mmap is available
+#ifndef _WIN32
+#define MAPPED_ROM
+#endif
+
 bool load_rom(GameBoy *, const char *);
+CartImage *load_cart_image(const char *);
+void release_cart_image(CartImage *);
+void attach_cart(GameBoy *, CartImage *);
+void detach_cart(GameBoy *);
 bool load_ram(GameBoy *);
 void save_ram(GameBoy *);
+uint16_t take_dirty_ram(GameBoy *);
+bool write_ram_banks(const char *, uint8_t *const *, uint16_t);
 
 void print_cart_info(GameBoy *);
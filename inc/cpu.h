@@ -3,8 +3,14 @@
 #include "gameboy.h"
 
 #define CPU_STEP 4
+#define IDLE_LOOP_MAX_LENGTH 16
 #define PROGRAM_START 0x100
 
+// Dispatch with computed gotos when the compiler supports them
+#if defined(__GNUC__) && !defined(JGBC_NO_THREADED_DISPATCH)
+#define THREADED_DISPATCH
+#endif
+
 // Shortcut Macros
 #define TICK(T)                                                                                                        \
     {                                                                                                                  \
@@ -14,6 +20,9 @@
 
 #define REG(N) gb->cpu.reg.N
 
+#define FETCH8() fetch_byte(gb)
+#define FETCH16() fetch_short(gb)
+
 #define READ8(addr) read_byte(gb, (addr), true)
 #define WRITE8(addr, value) write_byte(gb, (addr), (value), true)
 #define READ16(addr) read_short(gb, (addr), true)
@@ -72,17 +81,22 @@
 #define KEY1 0xFF4D
 #define KEY1_SPEED_PREPARE 0
 
+typedef void (*OpcodeHandler)(GameBoy *);
+
 typedef struct {
     const char *disassembly;
     uint8_t length;
     bool signed_operand;
     bool extended;
-    void *execute;
 } Instruction;
 
 void reset_cpu(GameBoy *gb);
-Instruction find_instr(GameBoy *, uint16_t);
+const Instruction *find_instr(GameBoy *, uint16_t);
 void update_cpu(GameBoy *);
+void run_cpu(GameBoy *, uint64_t);
+
+uint8_t fetch_byte(GameBoy *);
+uint16_t fetch_short(GameBoy *);
 
 void stack_push_byte(GameBoy *, uint8_t);
 void stack_push_short(GameBoy *, uint16_t);
@@ -95,5 +109,18 @@ void set_flag(GameBoy *, uint8_t, uint8_t);
 uint8_t get_flag(GameBoy *, uint8_t);
 
 void check_interrupts(GameBoy *);
-void set_div(GameBoy *, uint16_t value);
-void tick_timer(GameBoy *, uint8_t);
\ No newline at end of file
+void check_idle_loop(GameBoy *, uint16_t);
+void check_idle_branch(GameBoy *, uint16_t);
+void update_pending_interrupts(GameBoy *);
+void update_timer(GameBoy *);
+uint8_t timer_register_read(GameBoy *, uint16_t, uint8_t);
+void timer_register_write(GameBoy *, uint16_t, uint8_t);
+
+// Advances the timer clock, the registers only need updating when TIMA overflows
+static inline void tick_timer(GameBoy *gb, const uint32_t ticks) {
+    gb->cpu.timer.clock += ticks;
+
+    if (gb->cpu.timer.clock >= gb->cpu.timer.next_update) {
+        update_timer(gb);
+    }
+}
\ No newline at end of file
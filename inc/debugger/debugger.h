@@ -60,6 +60,7 @@ private:
 
     SDL_Window *_window;
     SDL_GLContext _gl_context;
+    SDL_AudioDeviceID _audio_device;
 
     bool _is_paused;
 
@@ -2,9 +2,11 @@
 
 namespace Emulator {
 extern "C" {
+#include "alu.h"
 #include "apu.h"
 #include "cart.h"
 #include "cpu.h"
+#include "frontend.h"
 #include "gameboy.h"
 #include "input.h"
 #include "mbc.h"
@@ -1,7 +1,7 @@
 #pragma once
 
 // Create local pointer named gb to use the C macros
-#define INIT_GB_CTX() static auto gb = debugger().gb().get()
+#define INIT_GB_CTX() auto *gb = debugger().gb().get()
 
 class Debugger;
 class Window {
@@ -1,5 +1,6 @@
 #pragma once
 #include "debugger/window.h"
+#include <cstdint>
 
 namespace Windows {
 class Breakpoints final : public Window {
@@ -9,5 +10,8 @@ public:
     void render() override;
 
     [[nodiscard]] constexpr const char *title() const override;
+
+private:
+    uint32_t _addr = 0;
 };
 }
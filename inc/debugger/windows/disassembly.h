@@ -19,10 +19,11 @@ public:
 
 private:
     std::optional<uint16_t> _address_to_scroll_to;
+    uint16_t _selected_label_addr;
     std::map<uint16_t, const std::string> _labels;
 
     static void draw_region_prefix(uint16_t addr);
-    void draw_instr_line(uint16_t, const Emulator::Instruction &);
+    void draw_instr_line(uint16_t, const Emulator::Instruction *);
     void draw_data_line(uint16_t) const;
 
     constexpr static bool is_executable(uint16_t);
@@ -11,9 +11,9 @@ public:
     void render() override;
     [[nodiscard]] constexpr const char *title() const override;
 
-    static void serial_write_handler(uint8_t);
+    static void serial_write_handler(void *, uint8_t);
 
 private:
-    static std::stringstream _buffer;
+    std::stringstream _buffer;
 };
 }
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "gameboy.h"
+#include <SDL.h>
+
+#define SCREEN_INITIAL_SCALE 4
+#define WINDOW_TITLE "jgbc"
+
+// Glue between the core and SDL, shared by the frontend and the debugger
+void set_key(GameBoy *, SDL_Scancode, bool);
+SDL_AudioDeviceID open_audio(GameBoy *, SDL_AudioDeviceID *);
@@ -4,13 +4,16 @@
 #define _CRT_SECURE_NO_WARNINGS
 #endif
 
-#include <SDL.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 struct GameBoy_s;
 typedef struct GameBoy_s GameBoy;
 
+struct Arena_s;
+typedef struct Arena_s Arena;
+
 typedef struct {
     union {
         struct {
@@ -49,16 +52,70 @@ typedef struct {
     bool IME;
 } Registers;
 
+// ALU operation whose flags have not been written to F yet
+typedef enum {
+    FlagsEvaluated,
+    FlagsAnd,
+    FlagsOr,
+    FlagsInc,
+    FlagsDec,
+    FlagsAdd,
+    FlagsAddCarry,
+    FlagsSub,
+    FlagsSubCarry,
+    FlagsAddShort,
+    FlagsAddSigned
+} FlagOp;
+
 typedef struct {
     bool is_halted;
     bool is_double_speed;
 
     Registers reg;
-    uint8_t ticks;
+    uint32_t ticks;
+
+    // IE & IF, kept up to date by writes to either register
+    uint8_t pending_interrupts;
 
-    uint16_t div;
-    bool div_overflow;
-    uint8_t div_overflow_ticks;
+    // Operand decoded ahead of time, returned by the fetches of an instruction run from a cached block
+    bool is_operand_decoded;
+    uint16_t decoded_operand;
+
+    // Host memory of the 256B page instructions were last fetched from, empty when length is 0
+    struct {
+        const uint8_t *memory;
+        uint16_t start;
+        uint16_t length;
+    } fetch;
+
+    // Flags are computed from the last ALU operation only when F is read
+    struct {
+        FlagOp op;
+        uint8_t carry;
+        uint8_t kept;
+        uint16_t a;
+        uint16_t b;
+    } flags;
+
+    // DIV and TIMA are derived from the CPU clock count, only the TIMA overflow needs an update
+    struct {
+        uint64_t clock;
+        uint64_t next_update;
+        uint64_t div_clock;
+        uint64_t tima_clock;
+        uint64_t overflow_clock;
+        uint8_t tima;
+        bool is_overflow_pending;
+    } timer;
+
+    // Last backward branch target, used to detect busy-wait loops
+    struct {
+        uint16_t address;
+        bool is_pure;
+        Registers reg;
+        uint64_t cycles;
+        uint64_t deadline;
+    } idle_loop;
 } CPU;
 
 typedef struct __attribute__((__packed__)) {
@@ -70,8 +127,6 @@ typedef struct __attribute__((__packed__)) {
 
 typedef struct {
     uint16_t *framebuffer;
-    uint16_t scan_clock;
-    uint16_t frame_clock;
     uint8_t window_ly;
 
     Sprite *sprite_buffer;
@@ -83,19 +138,57 @@ typedef struct {
     uint8_t current_scan_bg_colour[160];
     bool current_scan_bg_has_priority[160];
 
-    SDL_Window *window;
-    SDL_Renderer *renderer;
-    SDL_Texture *texture;
+    // Called with the framebuffer at the end of every frame, to present it
+    void (*frame_handler)(void *, const uint16_t *);
+    void *frame_user_data;
 } PPU;
 
 typedef enum { GeneralPurposeDMA = 0, HBlankDMA = 1 } HDMAMode;
 
+#define MMU_PAGE_COUNT 256
+#define MMU_PAGE_SHIFT 8
+
+// GBC Banks
+#define WRAM_BANK_COUNT 8
+#define VRAM_BANK_COUNT 2
+
+// Most RAM banks a cartridge can have
+#define EXTRAM_BANK_COUNT 16
+
+#define RTC_REGISTER_COUNT 5
+
+// What sets one kind of memory bank controller apart
 typedef struct {
-    uint16_t rom_bank;
-    uint8_t ram_bank;
-    uint8_t wram_bank;
-    uint8_t vram_bank;
+    void (*write)(GameBoy *, uint16_t, uint8_t); // Writes to the rom, the MBC registers
+
+    // Cart ram accesses while no bank is mapped there, reads give 0xFF when NULL
+    uint8_t (*read_ram)(GameBoy *, uint16_t);
+    void (*write_ram)(GameBoy *, uint16_t, uint8_t);
+} MBCType;
+
+// MBC3 clock, only brought up to date when the program looks at it
+typedef struct {
+    uint64_t seconds; // Counted up to start
+    uint64_t start;   // Cycle the current second began on
+    bool is_halted;
+    bool has_carry; // The day counter overflowed
+
+    uint8_t latched[RTC_REGISTER_COUNT];
+    uint8_t latch; // Last value written to the latch register
+} RTC;
 
+typedef struct {
+    bool ram_enabled;
+    bool mode;         // MBC1 ram banking mode
+    uint16_t rom_bank; // As written by the program, before masking
+    uint8_t ram_bank;  // The MBC1's upper bank bits, or the MBC3 clock register
+    uint16_t rom_mask; // Bank counts are powers of two
+    uint8_t ram_mask;
+    RTC rtc;
+} MBC;
+
+// The mapped banks and the page tables built from them come first, every memory access reads them
+typedef struct {
     uint8_t *rom00;  // 16KB ROM Bank
     uint8_t *romNN;  // 16KB Switchable ROM Bank
     uint8_t *vram;   // 8KB Video RAM
@@ -107,26 +200,36 @@ typedef struct {
     uint8_t *hram;   // 128B High RAM
     uint8_t *ier;    // 1B Interrupt Enable Register
 
-    uint8_t **wram_banks; // 8x4KB WRAM Banks (GBC Only)
-    uint8_t **vram_banks; // 2x8KB VRAM Banks (GBC Only)
+    // Host memory of each 256B page, NULL when accesses go through the slow path
+    uint8_t *read_pages[MMU_PAGE_COUNT];
+    uint8_t *write_pages[MMU_PAGE_COUNT];
 
-    void (*mbc_handler)(GameBoy *, uint16_t, uint8_t);
+    uint16_t rom00_bank;
+    uint16_t rom_bank;
+    uint8_t ram_bank;
+    uint8_t wram_bank;
+    uint8_t vram_bank;
+
+    uint8_t *wram_banks[WRAM_BANK_COUNT]; // 8x4KB WRAM Banks (GBC Only)
+    uint8_t *vram_banks[VRAM_BANK_COUNT]; // 2x8KB VRAM Banks (GBC Only)
+
+    const MBCType *mbc;
 
     struct {
         uint16_t address;
-        uint16_t clock;
         bool is_active;
     } dma;
 
     struct {
         uint16_t source_addr;
         uint16_t dest_addr;
-        uint8_t length;
+        uint16_t length; // Bytes left to copy
         HDMAMode mode;
         bool is_active;
     } hdma;
 
-    void (*serial_write_handler)(const uint8_t);
+    void (*serial_write_handler)(void *, uint8_t);
+    void *serial_user_data; // Passed back to the handler
 } MMU;
 
 typedef enum { Decrease = 0, Increase = 1 } EnvelopeMode;
@@ -163,7 +266,7 @@ typedef struct {
     ChannelEnvelope envelope;
     ChannelLength length;
 
-    int32_t clock;
+    uint32_t clock;
     uint16_t frequency;
 } SquareWave;
 
@@ -191,19 +294,21 @@ typedef struct {
 
 typedef struct {
     bool enabled;
-    SDL_AudioDeviceID device_id;
-    SDL_AudioSpec audio_spec;
 
     float *buffer;
     uint32_t buffer_position;
 
+    // Called with every full buffer of interleaved samples, to play them
+    void (*audio_handler)(void *, const float *, size_t);
+    void *audio_user_data;
+
+    // Cycle up to which the channels have been clocked
+    uint64_t last_update;
+
     struct {
         uint8_t step;
-        uint16_t clock;
     } frame_sequencer;
 
-    uint8_t downsample_clock;
-
     uint8_t left_volume;
     uint8_t right_volume;
 
@@ -216,19 +321,41 @@ typedef struct {
     Noise noise;
 } APU;
 
+// The rom and its header, immutable once loaded and shared by every instance running the cartridge
 typedef struct {
-    char filename[256];
+    uint32_t references; // Freed when the last holder releases it
 
+    char filename[256];
     char title[17]; // Uppercase ASCII Game Name
     bool is_colour;
     uint8_t type;
     uint16_t rom_size;
     uint8_t ram_size;
+    const MBCType *mbc; // NULL without a bank controller
 
+    uint8_t *rom; // Every rom bank, one after the other, read only
     uint8_t **rom_banks;
-    uint8_t **ram_banks;
+} CartImage;
+
+typedef struct {
+    CartImage *image;
+    MBC mbc;
+    uint8_t *ram_banks[EXTRAM_BANK_COUNT];
+    uint16_t dirty_banks; // Ram banks written since the last save, one bit each
 } Cart;
 
+// In the order of the joypad bits, buttons first
+typedef enum {
+    ButtonA = 0,
+    ButtonB = 1,
+    ButtonSelect = 2,
+    ButtonStart = 3,
+    ButtonRight = 4,
+    ButtonLeft = 5,
+    ButtonUp = 6,
+    ButtonDown = 7
+} Button;
+
 typedef struct {
     bool up;
     bool right;
@@ -240,16 +367,100 @@ typedef struct {
     bool b;
 } Input;
 
-struct GameBoy_s {
-    bool is_running;
+#define EVENT_COUNT 5
+
+typedef enum {
+    EventPPU = 0,
+    EventFrameSequencer = 1,
+    EventAudioSample = 2,
+    EventDMA = 3,
+    EventFrameEnd = 4
+} EventType;
+
+typedef struct {
+    uint64_t time;
+    EventType type;
+} Event;
+
+typedef struct {
+    uint64_t cycles;   // Elapsed clocks at normal speed
+    uint64_t deadline; // End of the current CPU run, an event scheduled before it moves it closer
+    bool is_frame_done;
+
+    // Binary min-heap ordered by time, each event type is pending at most once
+    Event queue[EVENT_COUNT];
+    uint8_t queue_length;
+    int8_t queue_index[EVENT_COUNT];
+} Scheduler;
+
+#define BLOCK_MAX_LENGTH 16
 
+// Pairs of instructions executed as one
+typedef enum { FusionNone, FusionDecJrNz, FusionLoadCompare } Fusion;
+
+// Machine code of a block, runs it until the deadline of the scheduler
+typedef void (*BlockCode)(GameBoy *);
+
+typedef struct {
+    void (*handler)(GameBoy *);
+    uint16_t operand;
+    uint8_t opcode;
+    uint8_t length;
+    Fusion fusion;
+} BlockInstruction;
+
+typedef struct {
+    const uint8_t *source; // Host address of the first instruction, tells banks apart
+    uint16_t address;
+    uint8_t length;
+    uint16_t hits; // Runs so far, the block is compiled to machine code once hot
+    BlockCode code; // NULL until the block is compiled
+    BlockInstruction instructions[BLOCK_MAX_LENGTH];
+} Block;
+
+// Block of the rom compiled ahead of time by jgbc_recomp
+typedef struct {
+    uint32_t offset; // Position of the first instruction in the rom file
+    BlockCode code;
+} RecompiledBlock;
+
+typedef struct {
+    Block *blocks;
+    uint8_t *code_map; // One bit per byte of work and high RAM holding cached code
+    bool is_stale;     // The running block may not match memory anymore
+    uint8_t *code_buffer; // Executable memory holding the machine code of hot blocks
+    uint32_t code_used;
+    const RecompiledBlock *recompiled; // Sorted by offset
+    uint32_t recompiled_count;
+} BlockCache;
+
+typedef struct {
+    uint64_t instructions;
+    uint64_t block_instructions; // Instructions run from cached blocks
+    uint64_t halt_skipped_cycles; // Clocks fast-forwarded while the CPU was halted
+    uint64_t idle_skipped_cycles; // Clocks fast-forwarded in busy-wait loops
+} Stats;
+
+// Ordered by how often the members are touched, the registers, clocks and memory map of every instruction come first
+// The sound and video state is read per sample and per pixel, the rest only on setup and on bank switches
+struct GameBoy_s {
     CPU cpu;
-    PPU ppu;
+    Scheduler scheduler;
+    Stats stats;
+    BlockCache block_cache;
     MMU mmu;
     APU apu;
+    PPU ppu;
     Cart cart;
     Input input;
+
+    Arena *arena;
+    bool is_running;
 };
 
 void init(GameBoy *gb);
 void reset(GameBoy *);
+void destroy(GameBoy *);
+
+void run_frame(GameBoy *);
+void run_instruction(GameBoy *);
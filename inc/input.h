@@ -13,9 +13,8 @@
 #define KEY_RIGHT_A 0x1
 
 // Shortcut Macros
-#define KEY_STATE (key.state == SDL_PRESSED) ? true : false
 #define SET_KEY(mask, value, input) ((value) ? ((input) ^= (mask)) : ((input) |= (mask)))
 
 void reset_input(GameBoy *);
-void set_key(GameBoy *, SDL_Scancode, bool);
-uint8_t joypad_state(GameBoy *);
+void set_button(GameBoy *, Button, bool);
+uint8_t joypad_state(GameBoy *, uint8_t);
@@ -1,5 +1,18 @@
 #pragma once
 
+#include "cart.h"
+#include "mmu.h"
+#include <SDL.h>
+
+// One minute of emulated time
+#define BENCHMARK_FRAMES 3600
+
+// Ten seconds of emulated time on each instance
+#define STRESS_FRAMES 600
+
+// Seconds between two writes of the cart ram changed in between
+#define SAVE_INTERVAL 1
+
 typedef struct {
     int invalid_option_index;
 
@@ -9,4 +22,29 @@ typedef struct {
     bool should_show_help;
     bool is_headless;
     bool should_print_info;
+    bool should_print_stats;
+    bool should_benchmark;
+    bool should_load_recompiled;
+    uint32_t stress_instances; // Instances run in parallel, 0 when not stress testing
+    uint32_t save_interval;    // Seconds between writes of the cart ram, 0 to only write it on exit
 } CliArgs;
+
+// What the running instance is presented on, nothing is opened when headless
+typedef struct {
+    SDL_Window *window;
+    SDL_Renderer *renderer;
+    SDL_Texture *texture;
+    SDL_AudioDeviceID audio_device; // 0 without audio
+} Frontend;
+
+// Writes the cart ram banks changed since the last flush on its own thread, the emulation never waits for the disk
+typedef struct {
+    SDL_Thread *thread;
+    SDL_mutex *lock;
+    SDL_cond *has_banks;
+    bool is_running;
+
+    char filename[256 + sizeof(SAVE_EXTENSION)];
+    uint16_t dirty_banks; // Copied from the instance and not written yet
+    uint8_t banks[EXTRAM_BANK_COUNT][EXTRAM_BANK_SIZE];
+} SaveWriter;
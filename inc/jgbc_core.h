@@ -0,0 +1,19 @@
+#pragma once
+
+#include "gameboy.h"
+
+// Embedding interface of the core, everything else stays available to the frontends in this tree
+// The framebuffer is SCREEN_WIDTH by SCREEN_HEIGHT pixels in ABGR1555
+// The audio is interleaved stereo floats at SAMPLE_RATE
+
+GameBoy *jgbc_create(void);
+void jgbc_destroy(GameBoy *);
+
+bool jgbc_load_rom(GameBoy *, const char *);
+void jgbc_run_frame(GameBoy *);
+
+const uint16_t *jgbc_framebuffer(GameBoy *);
+size_t jgbc_audio_samples(GameBoy *, float *, size_t);
+
+// Bit n set presses the Button n
+void jgbc_set_input(GameBoy *, uint8_t);
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "block.h"
+#include "gameboy.h"
+
+#define JIT_THRESHOLD 32
+#define JIT_BUFFER_SIZE (4 * 1024 * 1024)
+
+// Compile hot blocks to x86-64 machine code when enabled, only on the platforms it targets
+#if defined(JGBC_JIT) && defined(BLOCK_CACHE) && defined(__x86_64__) && defined(__unix__)
+#define JIT
+#endif
+
+void init_jit(GameBoy *);
+void free_jit(GameBoy *);
+bool compile_jit(GameBoy *, Block *);
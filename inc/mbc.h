@@ -2,8 +2,8 @@
 
 #include "gameboy.h"
 
-#define MBC1_RAM_ENABLE_END 0x1FFF
-#define MBC1_RAM_ENABLE_NIBBLE 0xA
+#define MBC_RAM_ENABLE_END 0x1FFF
+#define MBC_RAM_ENABLE_NIBBLE 0xA
 
 #define MBC1_ROM_CHANGE_START 0x2000
 #define MBC1_ROM_CHANGE_END 0x3FFF
@@ -11,22 +11,46 @@
 
 #define MBC1_ROM_RAM_CHANGE_START 0x4000
 #define MBC1_ROM_RAM_CHANGE_END 0x5FFF
-#define MBC1_ROM_RAM_CHANGE 0x60
+#define MBC1_ROM_RAM_CHANGE 0x3
+#define MBC1_ROM_RAM_CHANGE_SHIFT 5
 
 #define MBC1_MODE_CHANGE_START 0x6000
 #define MBC1_MODE_CHANGE_END 0x7FFF
 
+// Bit 8 of the address tells the two MBC2 registers apart
+#define MBC2_REGISTER_END 0x3FFF
+#define MBC2_ROM_SELECT 0x100
+#define MBC2_ROM_CHANGE 0xF
+#define MBC2_RAM_SIZE 512 // Half bytes, repeated over the whole ram area
+
+#define MBC3_ROM_CHANGE_END 0x3FFF
+#define MBC3_ROM_CHANGE 0x7F
+#define MBC3_RAM_CHANGE_END 0x5FFF
+#define MBC3_RTC_LATCH_END 0x7FFF
+
+// MBC3 clock registers, selected through the ram bank
+#define RTC_S 0x08
+#define RTC_M 0x09
+#define RTC_H 0x0A
+#define RTC_DL 0x0B
+#define RTC_DH 0x0C
+#define RTC_DH_DAY_HIGH 0
+#define RTC_DH_HALT 6
+#define RTC_DH_CARRY 7
+#define RTC_DAYS 512
+#define RTC_SECONDS_PER_DAY 86400
+
 #define MBC5_ROM_CHANGE_LOW_START 0x2000
 #define MBC5_ROM_CHANGE_LOW_END 0x2FFF
 #define MBC5_ROM_CHANGE_HIGH_START 0x3000
 #define MBC5_ROM_CHANGE_HIGH_END 0x3FFF
 #define MBC5_RAM_CHANGE_START 0x4000
 #define MBC5_RAM_CHANGE_END 0x5FFF
+#define MBC5_RAM_CHANGE 0xF
 
-typedef enum { RomBanking = 0, RamBanking = 1 } MBC1Mode;
+extern const MBCType mbc1;
+extern const MBCType mbc2;
+extern const MBCType mbc3;
+extern const MBCType mbc5;
 
-void mbc1_handler(GameBoy *, uint16_t, uint8_t);
-void mbc2_handler(GameBoy *, uint16_t, uint8_t);
-void mbc3_handler(GameBoy *, uint16_t, uint8_t);
-void mbc4_handler(GameBoy *, uint16_t, uint8_t);
-void mbc5_handler(GameBoy *, uint16_t, uint8_t);
+void reset_mbc(GameBoy *);
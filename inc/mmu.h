@@ -1,6 +1,8 @@
 #pragma once
 
+#include "cpu.h"
 #include "gameboy.h"
+#include "macro.h"
 
 // Macro Shortcuts
 #define SREAD8(addr) read_byte(gb, (addr), false)
@@ -8,8 +10,11 @@
 #define SREAD16(addr) read_short(gb, (addr), false)
 #define SWRITE16(addr, value) write_short(gb, (addr), (value), false)
 
-#define RREG(addr, bit) read_register(gb, addr, bit)
-#define WREG(addr, bit, value) write_register(gb, addr, bit, value)
+// Emulator-internal register access, skips the program-visible bus logic
+#define IREAD8(addr) io_read(gb, (addr))
+#define IWRITE8(addr, value) io_write(gb, (addr), (value))
+#define RREG(addr, bit) GET_BIT(io_read(gb, (addr)), (bit))
+#define WREG(addr, bit, value) io_write_bit(gb, (addr), (bit), (value))
 
 // Region Sizes
 #define ROM_BANK_SIZE 16384
@@ -47,12 +52,9 @@
 #define HRAM_END 0xFFFE
 #define IE_START_END 0xFFFF
 
-// GBC Banks
-#define WRAM_BANK_COUNT 8
-#define VRAM_BANK_COUNT 2
-
 // DMA
 #define DMA_CLOCKS 640
+#define DMA_LENGTH 0xA0
 
 // VRAM DMA (CGB)
 #define HDMA1 0xFF51
@@ -62,12 +64,23 @@
 #define HDMA5 0xFF55
 #define HDMA5_LENGTH 0x7F
 #define HDMA5_MODE 0x80
+#define HDMA_BLOCK_SIZE 0x10
+#define HDMA_BLOCK_CLOCKS 32 // The CPU is stopped for 8 machine cycles at normal speed
 
 // Serial output
 #define SB 0xFF01
+#define SC 0xFF02
+
+// Infrared port (CGB)
+#define RP 0xFF56
+
+// WRAM bank select (CGB)
+#define SVBK 0xFF70
+#define SVBK_BANK 0x7
 
 void init_mmu(GameBoy *);
 void reset_mmu(GameBoy *);
+void update_pages(GameBoy *);
 
 uint8_t read_byte(GameBoy *, uint16_t, bool);
 uint16_t read_short(GameBoy *, uint16_t, bool);
@@ -80,3 +93,25 @@ uint8_t read_register(GameBoy *, uint16_t, uint8_t);
 
 void update_dma(GameBoy *);
 void update_hdma(GameBoy *);
+
+// Register file storage of an IO register or IE
+static inline uint8_t *io_register(GameBoy *gb, const uint16_t address) {
+    return address == IE_START_END ? gb->mmu.ier : &gb->mmu.io[address - IO_START];
+}
+
+static inline uint8_t io_read(GameBoy *gb, const uint16_t address) { return *io_register(gb, address); }
+
+static inline void io_write(GameBoy *gb, const uint16_t address, const uint8_t value) {
+    *io_register(gb, address) = value;
+
+    if (address == IF || address == IE) {
+        update_pending_interrupts(gb);
+    }
+}
+
+static inline void io_write_bit(GameBoy *gb, const uint16_t address, const uint8_t bit, const uint8_t value) {
+    uint8_t byte = io_read(gb, address);
+    byte ^= (-value ^ byte) & (1 << bit);
+
+    io_write(gb, address, byte);
+}
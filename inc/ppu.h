@@ -6,9 +6,12 @@
 #define SCREEN_HEIGHT 144
 #define FRAMERATE 60.0
 #define CLOCKS_PER_SCANLINE 456
+#define SPRITES_PER_LINE 10
 
-#define SCREEN_INITIAL_SCALE 4
-#define WINDOW_TITLE "jgbc"
+// Length of each mode in a visible scanline
+#define OAM_TRANSFER_CLOCKS 80
+#define PIXEL_TRANSFER_CLOCKS 173
+#define HBLANK_CLOCKS (CLOCKS_PER_SCANLINE - OAM_TRANSFER_CLOCKS - PIXEL_TRANSFER_CLOCKS)
 
 // LCDC: LCD Control Register
 #define LCDC 0xFF40
@@ -110,10 +113,9 @@ typedef struct {
 
 void init_ppu(GameBoy *);
 void reset_ppu(GameBoy *);
-void init_window(GameBoy *);
 
-void render_framebuffer(GameBoy *);
-void update_ppu(GameBoy *);
+void update_ppu(GameBoy *, uint64_t);
+void lcdc_write(GameBoy *, uint8_t);
 
 void palette_index_write(GameBoy *, uint16_t, uint8_t);
 void palette_data_write(GameBoy *, uint16_t, uint8_t);
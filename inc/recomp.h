@@ -0,0 +1,40 @@
+#pragma once
+
+#include "block.h"
+#include "gameboy.h"
+
+// Libraries built by jgbc_recomp are loaded with dlopen
+#if defined(BLOCK_CACHE) && !defined(_WIN32)
+#define RECOMP
+#endif
+
+#define RECOMP_EXTENSION ".recomp.so"
+
+// Symbols exported by a recompiled rom library
+#define RECOMP_SYMBOL_HASH "jgbc_recomp_hash"
+#define RECOMP_SYMBOL_LAYOUT "jgbc_recomp_layout"
+#define RECOMP_SYMBOL_BLOCKS "jgbc_recomp_blocks"
+#define RECOMP_SYMBOL_BLOCK_COUNT "jgbc_recomp_block_count"
+
+// FNV-1a step, stays a constant expression so the generated library can store the result
+#define RECOMP_MIX(hash, value) ((((uint32_t) (hash)) ^ (uint32_t) (value)) * 0x01000193u)
+#define RECOMP_MEMBER(member, index)                                                                                   \
+    RECOMP_MIX(RECOMP_MIX(RECOMP_MIX(0x811C9DC5u, index), offsetof(GameBoy, member)), sizeof(((GameBoy *) 0)->member))
+
+// Hash of every member that the inlined begin_block_instruction, end_block_instruction and instruction bodies access
+// at fixed offsets, a library built against another layout of them is rejected
+#define RECOMP_LAYOUT                                                                                                  \
+    ((uint32_t) (RECOMP_MEMBER(cpu.reg.PC, 0) + RECOMP_MEMBER(cpu.ticks, 1) +                                          \
+                 RECOMP_MEMBER(cpu.decoded_operand, 2) + RECOMP_MEMBER(cpu.is_double_speed, 3) +                       \
+                 RECOMP_MEMBER(cpu.is_halted, 4) + RECOMP_MEMBER(cpu.timer.clock, 5) +                                 \
+                 RECOMP_MEMBER(cpu.timer.next_update, 6) +                                                             \
+                 RECOMP_MEMBER(stats.instructions, 7) + RECOMP_MEMBER(stats.block_instructions, 8) +                   \
+                 RECOMP_MEMBER(scheduler.cycles, 9) + RECOMP_MEMBER(scheduler.deadline, 10) +                          \
+                 RECOMP_MEMBER(block_cache.is_stale, 11) + RECOMP_MEMBER(cpu.reg.A, 12) +                              \
+                 RECOMP_MEMBER(cpu.reg.B, 13) + RECOMP_MEMBER(cpu.reg.C, 14) + RECOMP_MEMBER(cpu.reg.D, 15) +          \
+                 RECOMP_MEMBER(cpu.reg.E, 16) + RECOMP_MEMBER(cpu.reg.H, 17) + RECOMP_MEMBER(cpu.reg.L, 18) +          \
+                 RECOMP_MEMBER(cpu.reg.SP, 19) + RECOMP_MIX(0x811C9DC5u, sizeof(RecompiledBlock))))
+
+uint64_t hash_rom(GameBoy *);
+bool load_recompiled(GameBoy *);
+BlockCode find_recompiled(GameBoy *, uint16_t, uint16_t);
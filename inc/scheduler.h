@@ -0,0 +1,16 @@
+#pragma once
+
+#include "gameboy.h"
+
+// Length of the slice of emulation run between two host frames
+#define FRAME_CYCLES ((uint64_t) (CLOCK_SPEED / FRAMERATE))
+
+void reset_scheduler(GameBoy *);
+
+void schedule_event(GameBoy *, EventType, uint64_t);
+void cancel_event(GameBoy *, EventType);
+void run_events(GameBoy *);
+uint64_t next_sync_time(const GameBoy *);
+
+// The frame end event is always pending, so the queue is never empty
+static inline uint64_t next_event_time(const GameBoy *gb) { return gb->scheduler.queue[0].time; }
@@ -2,17 +2,147 @@
 #include "cpu.h"
 #include "macro.h"
 
+#ifdef VERIFY_LAZY_FLAGS
+#include <stdio.h>
+#include <stdlib.h>
+#endif
+
+static uint8_t compute_flags(const GameBoy *);
+static uint8_t pending_carry(const GameBoy *);
+static void defer_flags(GameBoy *, FlagOp, uint16_t, uint16_t, uint8_t, uint8_t);
+static void set_flags(GameBoy *, bool, bool, bool, bool);
+#ifdef VERIFY_LAZY_FLAGS
+static void verify_flags(GameBoy *, uint8_t);
+static uint8_t put_flag(uint8_t, uint8_t, bool);
 static bool did_byte_half_carry(uint8_t, uint8_t);
 static bool did_byte_full_carry(uint8_t, uint8_t);
 static bool did_byte_half_borrow(uint8_t, uint8_t);
 static bool did_byte_full_borrow(uint8_t, uint8_t);
 static bool did_short_half_carry(uint16_t, uint16_t);
 static bool did_short_full_carry(uint16_t, uint16_t);
+#endif
+
+#define FLAGS(z, n, h, c) ((z) << FLAG_ZERO | (n) << FLAG_SUBTRACT | (h) << FLAG_HALFCARRY | (c) << FLAG_CARRY)
 
 /*
- *   Helper Functions
+ *   Lazy Flags
  */
 
+// Writes the flags of the last deferred operation to F
+void evaluate_flags(GameBoy *gb) {
+    if (gb->cpu.flags.op == FlagsEvaluated) {
+        return;
+    }
+
+    REG(F) = compute_flags(gb);
+    gb->cpu.flags.op = FlagsEvaluated;
+}
+
+static uint8_t compute_flags(const GameBoy *gb) {
+    const uint16_t a = gb->cpu.flags.a;
+    const uint16_t b = gb->cpu.flags.b;
+    const uint8_t carry = gb->cpu.flags.carry;
+    const uint8_t kept = gb->cpu.flags.kept;
+
+    switch (gb->cpu.flags.op) {
+    case FlagsEvaluated:
+        return REG(F);
+
+    // The result is stored in a
+    case FlagsAnd:
+        return FLAGS(a == 0, 0, 1, 0);
+
+    case FlagsOr:
+        return FLAGS(a == 0, 0, 0, 0);
+
+    case FlagsInc:
+        return kept | FLAGS((uint8_t) (a + 1) == 0, 0, (a & 0xF) == 0xF, 0);
+
+    case FlagsDec:
+        return kept | FLAGS((uint8_t) (a - 1) == 0, 1, (a & 0xF) == 0, 0);
+
+    case FlagsAdd:
+    case FlagsAddCarry:
+        return FLAGS((uint8_t) (a + b + carry) == 0, 0, (a & 0xF) + (b & 0xF) + carry > 0xF, a + b + carry > 0xFF);
+
+    case FlagsSub:
+    case FlagsSubCarry:
+        return FLAGS((uint8_t) (a - b - carry) == 0, 1, (a & 0xF) < (b & 0xF) + carry, a < b + carry);
+
+    case FlagsAddShort:
+        return kept | FLAGS(0, 0, (a & 0xFFF) + (b & 0xFFF) > 0xFFF, a + b > 0xFFFF);
+
+    // Carries out of the low byte of SP
+    case FlagsAddSigned:
+        return FLAGS(0, 0, (a & 0xF) + (b & 0xF) > 0xF, (a & 0xFF) + b > 0xFF);
+    }
+
+    return REG(F);
+}
+
+// Carry flag of the deferred operation, computed alone and without writing F
+// Most instructions that read the carry defer their own flags right after
+static uint8_t pending_carry(const GameBoy *gb) {
+    const uint16_t a = gb->cpu.flags.a;
+    const uint16_t b = gb->cpu.flags.b;
+    const uint8_t carry = gb->cpu.flags.carry;
+
+    switch (gb->cpu.flags.op) {
+    case FlagsEvaluated:
+        return GET_BIT(REG(F), FLAG_CARRY);
+
+    case FlagsAnd:
+    case FlagsOr:
+        return 0;
+
+    case FlagsInc:
+    case FlagsDec:
+        return GET_BIT(gb->cpu.flags.kept, FLAG_CARRY);
+
+    case FlagsAdd:
+    case FlagsAddCarry:
+        return a + b + carry > 0xFF;
+
+    case FlagsSub:
+    case FlagsSubCarry:
+        return a < b + carry;
+
+    case FlagsAddShort:
+        return a + b > 0xFFFF;
+
+    case FlagsAddSigned:
+        return (a & 0xFF) + b > 0xFF;
+    }
+
+    return GET_BIT(REG(F), FLAG_CARRY);
+}
+
+// Records the operation instead of computing its flags, kept holds the flags it leaves untouched
+static void defer_flags(GameBoy *gb, const FlagOp op, const uint16_t a, const uint16_t b, const uint8_t carry,
+                        const uint8_t kept) {
+#ifdef VERIFY_LAZY_FLAGS
+    evaluate_flags(gb);
+    const uint8_t before = REG(F);
+#endif
+
+    gb->cpu.flags.op = op;
+    gb->cpu.flags.a = a;
+    gb->cpu.flags.b = b;
+    gb->cpu.flags.carry = carry;
+    gb->cpu.flags.kept = kept;
+
+#ifdef VERIFY_LAZY_FLAGS
+    verify_flags(gb, before);
+#endif
+}
+
+// Overwrites all the flags, dropping any deferred operation
+static void set_flags(GameBoy *gb, const bool zero, const bool subtract, const bool half_carry, const bool carry) {
+    gb->cpu.flags.op = FlagsEvaluated;
+    REG(F) = FLAGS(zero, subtract, half_carry, carry);
+}
+
+#ifdef VERIFY_LAZY_FLAGS
 static bool did_byte_half_carry(const uint8_t a, const uint8_t b) { return ((a & 0xF) + (b & 0xF)) > 0xF; }
 
 static bool did_byte_half_borrow(const uint8_t a, const uint8_t b) { return ((a & 0xF) < (b & 0xF)); }
@@ -25,126 +155,148 @@ static bool did_short_half_carry(const uint16_t a, const uint16_t b) { return (a
 
 static bool did_short_full_carry(const uint16_t a, const uint16_t b) { return ((a + b) & 0xF0000) > 0; }
 
+static uint8_t put_flag(const uint8_t flags, const uint8_t flag, const bool value) {
+    return value ? flags | (1 << flag) : flags & ~(1 << flag);
+}
+
+// Computes the flags of the deferred operation eagerly from the previous F and aborts when the lazy ones differ
+static void verify_flags(GameBoy *gb, const uint8_t before) {
+    const uint16_t a = gb->cpu.flags.a;
+    const uint16_t b = gb->cpu.flags.b;
+    const uint8_t carry = gb->cpu.flags.carry;
+    uint8_t eager = before;
+
+    switch (gb->cpu.flags.op) {
+    case FlagsEvaluated:
+        return;
+
+    case FlagsAnd:
+    case FlagsOr:
+        eager = put_flag(eager, FLAG_ZERO, a == 0);
+        eager = put_flag(eager, FLAG_SUBTRACT, 0);
+        eager = put_flag(eager, FLAG_HALFCARRY, gb->cpu.flags.op == FlagsAnd);
+        eager = put_flag(eager, FLAG_CARRY, 0);
+        break;
+
+    case FlagsInc:
+        eager = put_flag(eager, FLAG_ZERO, (uint8_t) (a + 1) == 0);
+        eager = put_flag(eager, FLAG_SUBTRACT, 0);
+        eager = put_flag(eager, FLAG_HALFCARRY, did_byte_half_carry(a, 1));
+        break;
+
+    case FlagsDec:
+        eager = put_flag(eager, FLAG_ZERO, (uint8_t) (a - 1) == 0);
+        eager = put_flag(eager, FLAG_SUBTRACT, 1);
+        eager = put_flag(eager, FLAG_HALFCARRY, did_byte_half_borrow(a, 1));
+        break;
+
+    case FlagsAdd:
+    case FlagsAddCarry:
+        eager = put_flag(eager, FLAG_ZERO, (uint8_t) (a + b + carry) == 0);
+        eager = put_flag(eager, FLAG_SUBTRACT, 0);
+        eager = put_flag(eager, FLAG_HALFCARRY, did_byte_half_carry(a, carry) || did_byte_half_carry(a + carry, b));
+        eager = put_flag(eager, FLAG_CARRY, did_byte_full_carry(a, carry) || did_byte_full_carry(a + carry, b));
+        break;
+
+    case FlagsSub:
+    case FlagsSubCarry:
+        eager = put_flag(eager, FLAG_ZERO, (uint8_t) (a - b - carry) == 0);
+        eager = put_flag(eager, FLAG_SUBTRACT, 1);
+        eager = put_flag(eager, FLAG_HALFCARRY, did_byte_half_borrow(a, carry) || did_byte_half_borrow(a - carry, b));
+        eager = put_flag(eager, FLAG_CARRY, did_byte_full_borrow(a, carry) || did_byte_full_borrow(a - carry, b));
+        break;
+
+    case FlagsAddShort:
+        eager = put_flag(eager, FLAG_SUBTRACT, 0);
+        eager = put_flag(eager, FLAG_HALFCARRY, did_short_half_carry(a, b));
+        eager = put_flag(eager, FLAG_CARRY, did_short_full_carry(a, b));
+        break;
+
+    case FlagsAddSigned:
+        eager = put_flag(eager, FLAG_ZERO, 0);
+        eager = put_flag(eager, FLAG_SUBTRACT, 0);
+        eager = put_flag(eager, FLAG_HALFCARRY, did_byte_half_carry(a & 0xFF, b));
+        eager = put_flag(eager, FLAG_CARRY, did_byte_full_carry(a & 0xFF, b));
+        break;
+    }
+
+    const uint8_t lazy = compute_flags(gb);
+
+    if (lazy != eager) {
+        fprintf(stderr, "Lazy flags mismatch at %04X: op %d a=%04X b=%04X carry=%d, lazy %02X, eager %02X\n", REG(PC),
+                gb->cpu.flags.op, a, b, carry, lazy, eager);
+        abort();
+    }
+}
+#endif
+
 /*
  *   Instruction ALU
  */
 
 uint8_t and(GameBoy * gb, const uint8_t a, const uint8_t b) {
     const uint8_t result = a & b;
-
-    FSET(FLAG_ZERO, result == 0);
-    FSET(FLAG_SUBTRACT, 0);
-    FSET(FLAG_HALFCARRY, 1);
-    FSET(FLAG_CARRY, 0);
+    defer_flags(gb, FlagsAnd, result, 0, 0, 0);
 
     return result;
 }
 
 uint8_t or(GameBoy * gb, const uint8_t a, const uint8_t b) {
     const uint8_t result = a | b;
-
-    FSET(FLAG_ZERO, result == 0);
-    FSET(FLAG_SUBTRACT, 0);
-    FSET(FLAG_HALFCARRY, 0);
-    FSET(FLAG_CARRY, 0);
+    defer_flags(gb, FlagsOr, result, 0, 0, 0);
 
     return result;
 }
 
 uint8_t xor(GameBoy * gb, const uint8_t a, const uint8_t b) {
     const uint8_t result = a ^ b;
-
-    FSET(FLAG_ZERO, result == 0);
-    FSET(FLAG_SUBTRACT, 0);
-    FSET(FLAG_HALFCARRY, 0);
-    FSET(FLAG_CARRY, 0);
+    defer_flags(gb, FlagsOr, result, 0, 0, 0);
 
     return result;
 }
 
 uint8_t inc(GameBoy *gb, const uint8_t operand) {
-    const uint8_t result = operand + 1;
-
-    FSET(FLAG_ZERO, result == 0);
-    FSET(FLAG_SUBTRACT, 0);
-    FSET(FLAG_HALFCARRY, did_byte_half_carry(operand, 1));
-
-    return result;
+    defer_flags(gb, FlagsInc, operand, 0, 0, pending_carry(gb) << FLAG_CARRY);
+    return operand + 1;
 }
 
 uint8_t dec(GameBoy *gb, const uint8_t operand) {
-    const uint8_t result = operand - 1;
-
-    FSET(FLAG_ZERO, result == 0);
-    FSET(FLAG_SUBTRACT, 1);
-    FSET(FLAG_HALFCARRY, did_byte_half_borrow(operand, 1));
-
-    return result;
+    defer_flags(gb, FlagsDec, operand, 0, 0, pending_carry(gb) << FLAG_CARRY);
+    return operand - 1;
 }
 
 uint8_t add_byte(GameBoy *gb, const uint8_t a, const uint8_t b) {
-    const uint8_t result = a + b;
-
-    FSET(FLAG_ZERO, result == 0);
-    FSET(FLAG_SUBTRACT, 0);
-    FSET(FLAG_HALFCARRY, did_byte_half_carry(a, b));
-    FSET(FLAG_CARRY, did_byte_full_carry(a, b));
-
-    return result;
+    defer_flags(gb, FlagsAdd, a, b, 0, 0);
+    return a + b;
 }
 
 uint8_t add_byte_carry(GameBoy *gb, const uint8_t a, const uint8_t b) {
-    const uint8_t carry = FGET(FLAG_CARRY);
-    const uint8_t result = a + b + carry;
+    const uint8_t carry = pending_carry(gb);
+    defer_flags(gb, FlagsAddCarry, a, b, carry, 0);
 
-    FSET(FLAG_ZERO, result == 0);
-    FSET(FLAG_SUBTRACT, 0);
-    FSET(FLAG_HALFCARRY, did_byte_half_carry(a, carry) || did_byte_half_carry(a + carry, b));
-    FSET(FLAG_CARRY, did_byte_full_carry(a, carry) || did_byte_full_carry(a + carry, b));
-
-    return result;
+    return a + b + carry;
 }
 
 uint8_t sub_byte(GameBoy *gb, const uint8_t a, const uint8_t b) {
-    const uint8_t result = a - b;
-
-    FSET(FLAG_ZERO, result == 0);
-    FSET(FLAG_SUBTRACT, 1);
-    FSET(FLAG_HALFCARRY, did_byte_half_borrow(a, b));
-    FSET(FLAG_CARRY, did_byte_full_borrow(a, b));
-
-    return result;
+    defer_flags(gb, FlagsSub, a, b, 0, 0);
+    return a - b;
 }
 
 uint8_t sub_byte_carry(GameBoy *gb, const uint8_t a, const uint8_t b) {
-    const uint8_t carry = FGET(FLAG_CARRY);
-    const uint8_t result = a - b - carry;
-
-    FSET(FLAG_ZERO, result == 0);
-    FSET(FLAG_SUBTRACT, 1);
-    FSET(FLAG_HALFCARRY, did_byte_half_borrow(a, carry) || did_byte_half_borrow(a - carry, b));
-    FSET(FLAG_CARRY, did_byte_full_borrow(a, carry) || did_byte_full_borrow(a - carry, b));
+    const uint8_t carry = pending_carry(gb);
+    defer_flags(gb, FlagsSubCarry, a, b, carry, 0);
 
-    return result;
+    return a - b - carry;
 }
 
 uint16_t add_short(GameBoy *gb, const uint16_t a, const uint16_t b) {
-    const uint16_t result = a + b;
-
-    FSET(FLAG_SUBTRACT, 0);
-    FSET(FLAG_HALFCARRY, did_short_half_carry(a, b));
-    FSET(FLAG_CARRY, did_short_full_carry(a, b));
-
-    return result;
+    defer_flags(gb, FlagsAddShort, a, b, 0, FGET(FLAG_ZERO) << FLAG_ZERO);
+    return a + b;
 }
 
 // Designed to add a signed value to the SP register (only used in 2 instructions)
 uint16_t add_sp_signed_byte(GameBoy *gb, const uint16_t sp, const int8_t operand) {
-    FSET(FLAG_ZERO, 0);
-    FSET(FLAG_SUBTRACT, 0);
-    FSET(FLAG_HALFCARRY, did_byte_half_carry(sp & 0xFF, (uint8_t) operand));
-    FSET(FLAG_CARRY, did_byte_full_carry(sp & 0xFF, (uint8_t) operand));
-
+    defer_flags(gb, FlagsAddSigned, sp, (uint8_t) operand, 0, 0);
     return sp + operand;
 }
 
@@ -153,12 +305,9 @@ uint8_t rotate_left(GameBoy *gb, const uint8_t operand, const bool affect_zero)
 
     // Shift the carry flag onto the result
     const uint8_t result = (operand << 1) | FGET(FLAG_CARRY);
-    FSET(FLAG_ZERO, (result == 0) && affect_zero);
-    FSET(FLAG_SUBTRACT, 0);
-    FSET(FLAG_HALFCARRY, 0);
 
     // Set the carry flag to the old bit 7
-    FSET(FLAG_CARRY, (operand & 0x80) >> 7);
+    set_flags(gb, (result == 0) && affect_zero, 0, 0, (operand & 0x80) >> 7);
 
     return result;
 }
@@ -169,12 +318,8 @@ uint8_t rotate_right(GameBoy *gb, const uint8_t operand) {
     // Shift the carry flag onto the result
     const uint8_t result = (operand >> 1) | (FGET(FLAG_CARRY) << 7);
 
-    FSET(FLAG_ZERO, result == 0);
-    FSET(FLAG_SUBTRACT, 0);
-    FSET(FLAG_HALFCARRY, 0);
-
     // Set the carry flag to the old bit 0
-    FSET(FLAG_CARRY, operand & 0x01);
+    set_flags(gb, result == 0, 0, 0, operand & 0x01);
 
     return result;
 }
@@ -184,12 +329,9 @@ uint8_t rotate_left_carry(GameBoy *gb, const uint8_t operand, const bool affect_
 
     // Shift bit 0 onto the top
     const uint8_t result = ((operand << 1) | (operand >> 7));
-    FSET(FLAG_ZERO, (result == 0) && affect_zero);
-    FSET(FLAG_SUBTRACT, 0);
-    FSET(FLAG_HALFCARRY, 0);
 
     // Set the carry flag to the old bit 7
-    FSET(FLAG_CARRY, (operand & 0x80) >> 7);
+    set_flags(gb, (result == 0) && affect_zero, 0, 0, (operand & 0x80) >> 7);
 
     return result;
 }
@@ -199,12 +341,9 @@ uint8_t rotate_right_carry(GameBoy *gb, const uint8_t operand, const bool affect
 
     // Shift bit 0 onto the top
     const uint8_t result = ((operand >> 1) | (operand << 7));
-    FSET(FLAG_ZERO, (result == 0) && affect_zero);
-    FSET(FLAG_SUBTRACT, 0);
-    FSET(FLAG_HALFCARRY, 0);
 
     // Set the carry flag to the old bit 0
-    FSET(FLAG_CARRY, operand & 0x01);
+    set_flags(gb, (result == 0) && affect_zero, 0, 0, operand & 0x01);
 
     return result;
 }
@@ -212,15 +351,11 @@ uint8_t rotate_right_carry(GameBoy *gb, const uint8_t operand, const bool affect
 // Shift 0 on the bottom and pop the top into the carry flag
 uint8_t shift_left_arith(GameBoy *gb, const uint8_t operand) {
 
-    // Set the carry flag to the old bit 7
-    FSET(FLAG_CARRY, (operand & 0x80) >> 7);
-
-    FSET(FLAG_SUBTRACT, 0);
-    FSET(FLAG_HALFCARRY, 0);
-
     // Shift left (set bit 0 to 0)
     const uint8_t result = operand << 1;
-    FSET(FLAG_ZERO, result == 0);
+
+    // Set the carry flag to the old bit 7
+    set_flags(gb, result == 0, 0, 0, (operand & 0x80) >> 7);
 
     return result;
 }
@@ -228,15 +363,11 @@ uint8_t shift_left_arith(GameBoy *gb, const uint8_t operand) {
 // Shift the top bit onto the top and pop the bottom into the carry flag
 uint8_t shift_right_arith(GameBoy *gb, const uint8_t operand) {
 
-    // Set the carry flag to the old bit 0
-    FSET(FLAG_CARRY, operand & 1);
-
-    FSET(FLAG_SUBTRACT, 0);
-    FSET(FLAG_HALFCARRY, 0);
-
     // Shift right
     const uint8_t result = (operand & 0x80) | (operand >> 1);
-    FSET(FLAG_ZERO, result == 0);
+
+    // Set the carry flag to the old bit 0
+    set_flags(gb, result == 0, 0, 0, operand & 1);
 
     return result;
 }
@@ -244,15 +375,11 @@ uint8_t shift_right_arith(GameBoy *gb, const uint8_t operand) {
 // Shift 0 onto the top and pop the bottom into the carry flag
 uint8_t shift_right_logic(GameBoy *gb, const uint8_t operand) {
 
-    // Set the carry flag to the old bit 0
-    FSET(FLAG_CARRY, operand & 0x01);
-
-    FSET(FLAG_SUBTRACT, 0);
-    FSET(FLAG_HALFCARRY, 0);
-
     // Shift right
     const uint8_t result = operand >> 1;
-    FSET(FLAG_ZERO, result == 0);
+
+    // Set the carry flag to the old bit 0
+    set_flags(gb, result == 0, 0, 0, operand & 0x01);
 
     return result;
 }
@@ -260,21 +387,15 @@ uint8_t shift_right_logic(GameBoy *gb, const uint8_t operand) {
 // Swap the top and bottom nibbles of the operand
 uint8_t swap(GameBoy *gb, const uint8_t operand) {
     const uint8_t result = ((operand & 0xF0) >> 4) | ((operand & 0x0F) << 4);
-
-    FSET(FLAG_ZERO, result == 0);
-    FSET(FLAG_SUBTRACT, 0);
-    FSET(FLAG_HALFCARRY, 0);
-    FSET(FLAG_CARRY, 0);
+    set_flags(gb, result == 0, 0, 0, 0);
 
     return result;
 }
 
+// The carry flag is left untouched
 void test_bit(GameBoy *gb, const uint8_t regis, const uint8_t bit) {
-    const uint8_t bit_val = GET_BIT(regis, bit);
-
-    FSET(FLAG_ZERO, bit_val == 0);
-    FSET(FLAG_SUBTRACT, 0);
-    FSET(FLAG_HALFCARRY, 1);
+    const uint8_t carry = FGET(FLAG_CARRY);
+    set_flags(gb, GET_BIT(regis, bit) == 0, 0, 1, carry);
 }
 
 uint8_t reset_bit(const uint8_t regis, const uint8_t bit) {
@@ -2,46 +2,45 @@
 #include "cpu.h"
 #include "macro.h"
 #include "mmu.h"
+#include "scheduler.h"
 #include <assert.h>
 #include <stdlib.h>
 #include <string.h>
 
 static void disable_apu(GameBoy *gb);
+static void sync_channels(GameBoy *gb, uint64_t time);
+static uint32_t advance_timer(uint32_t *clock, uint32_t period, uint32_t cycles);
 
 static void update_envelope(ChannelEnvelope *);
 static void update_length(ChannelLength *, bool *);
 
 static void reset_square_wave(GameBoy *gb, uint8_t idx);
 static void read_square(GameBoy *, uint16_t, uint8_t, uint8_t);
-static void update_square(GameBoy *, uint8_t);
+static void update_square(GameBoy *, uint8_t, uint32_t);
+static void output_square(GameBoy *, uint8_t);
 static void update_square_sweep(GameBoy *);
 static void trigger_square(GameBoy *, uint8_t);
 
 static void reset_wave(GameBoy *gb);
 static void read_wave(GameBoy *, uint16_t, uint8_t);
-static void update_wave(GameBoy *);
+static void update_wave(GameBoy *, uint32_t);
+static void output_wave(GameBoy *);
 static void trigger_wave(GameBoy *);
 
 static void reset_noise(GameBoy *gb);
 static void read_noise(GameBoy *, uint16_t, uint8_t);
-static void update_noise(GameBoy *);
+static void update_noise(GameBoy *, uint32_t);
+static void output_noise(GameBoy *);
 static void trigger_noise(GameBoy *);
 
 void init_apu(GameBoy *gb) {
-    SDL_AudioSpec desired_spec;
-    SDL_zero(desired_spec);
-
-    desired_spec.freq = SAMPLE_RATE;
-    desired_spec.format = AUDIO_F32SYS;
-    desired_spec.channels = AUDIO_CHANNELS;
-    desired_spec.samples = AUDIO_SAMPLES;
-
-    gb->apu.device_id =
-        SDL_OpenAudioDevice(NULL, 0, &desired_spec, &gb->apu.audio_spec, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
-
-    gb->apu.buffer = malloc(gb->apu.audio_spec.size);
+    gb->apu.buffer = malloc(AUDIO_BUFFER_SIZE * sizeof(float));
+    gb->apu.audio_handler = NULL;
+    gb->apu.audio_user_data = NULL;
 }
 
+void free_apu(GameBoy *gb) { free(gb->apu.buffer); }
+
 void reset_apu(GameBoy *gb) {
     reset_square_wave(gb, 0);
     reset_square_wave(gb, 1);
@@ -54,15 +53,17 @@ void reset_apu(GameBoy *gb) {
     }
 
     gb->apu.enabled = true;
-    gb->apu.frame_sequencer.clock = 0;
     gb->apu.frame_sequencer.step = 0;
-    gb->apu.downsample_clock = 0;
+    gb->apu.last_update = gb->scheduler.cycles;
 
     gb->apu.left_volume = 0;
     gb->apu.right_volume = 0;
 
     gb->apu.buffer_position = 0;
-    memset(gb->apu.buffer, 0, gb->apu.audio_spec.size);
+    memset(gb->apu.buffer, 0, AUDIO_BUFFER_SIZE * sizeof(float));
+
+    schedule_event(gb, EventFrameSequencer, gb->scheduler.cycles + FRAME_SEQUENCER_DIVIDER);
+    schedule_event(gb, EventAudioSample, gb->scheduler.cycles + DOWNSAMPLE_DIVIDER);
 }
 
 static void disable_apu(GameBoy *gb) {
@@ -74,7 +75,7 @@ static void disable_apu(GameBoy *gb) {
 
     // When APU is disabled, all registers are reset to 0
     for (uint16_t addr = NR10; addr <= NR52; ++addr) {
-        SWRITE8(addr, 0);
+        IWRITE8(addr, 0);
         audio_register_read(gb, addr, 0);
     }
 }
@@ -134,82 +135,118 @@ static void reset_noise(GameBoy *gb) {
     noise->width_mode = 0;
 }
 
-void update_apu(GameBoy *gb) {
+// Clocks the channel timers in bulk up to the given time
+static void sync_channels(GameBoy *gb, const uint64_t time) {
+    const uint32_t cycles = (uint32_t)(time - gb->apu.last_update);
+    gb->apu.last_update = time;
+
+    if (!gb->apu.enabled || cycles == 0) {
+        return;
+    }
+
+    update_square(gb, 0, cycles);
+    update_square(gb, 1, cycles);
+    update_wave(gb, cycles);
+    update_noise(gb, cycles);
+}
+
+// Counts down a channel timer which reloads to period after reaching 0, returns the number of reloads
+static uint32_t advance_timer(uint32_t *clock, const uint32_t period, uint32_t cycles) {
+    if (cycles <= *clock) {
+        *clock -= cycles;
+        return 0;
+    }
+
+    cycles -= *clock + 1;
+    *clock = period - cycles % (period + 1);
+
+    return 1 + cycles / (period + 1);
+}
+
+void update_frame_sequencer(GameBoy *gb, const uint64_t time) {
     APU *apu = &gb->apu;
+    schedule_event(gb, EventFrameSequencer, time + FRAME_SEQUENCER_DIVIDER);
 
     if (!apu->enabled) {
         return;
     }
 
-    for (int i = 0; i < gb->cpu.ticks; ++i) {
-        if (apu->frame_sequencer.clock >= FRAME_SEQUENCER_DIVIDER) {
-            apu->frame_sequencer.clock = 0;
-            apu->frame_sequencer.step++;
-            apu->frame_sequencer.step %= 9;
-
-            switch (gb->apu.frame_sequencer.step) {
-            case 2:
-            case 6:
-                update_square_sweep(gb);
-                // fallthrough
-            case 0:
-            case 4:
-                update_length(&apu->square_waves[0].length, &apu->square_waves[0].enabled);
-                update_length(&apu->square_waves[1].length, &apu->square_waves[1].enabled);
-                update_length(&apu->wave.length, &apu->wave.enabled);
-                update_length(&apu->noise.length, &apu->noise.enabled);
-                break;
-
-            case 7: // every 8 clocks
-                update_envelope(&apu->square_waves[0].envelope);
-                update_envelope(&apu->square_waves[1].envelope);
-                update_envelope(&apu->noise.envelope);
-                break;
-            }
-        } else {
-            apu->frame_sequencer.clock++;
-        }
+    sync_channels(gb, time);
+
+    apu->frame_sequencer.step++;
+    apu->frame_sequencer.step %= 9;
+
+    switch (apu->frame_sequencer.step) {
+    case 2:
+    case 6:
+        update_square_sweep(gb);
+        // fallthrough
+    case 0:
+    case 4:
+        update_length(&apu->square_waves[0].length, &apu->square_waves[0].enabled);
+        update_length(&apu->square_waves[1].length, &apu->square_waves[1].enabled);
+        update_length(&apu->wave.length, &apu->wave.enabled);
+        update_length(&apu->noise.length, &apu->noise.enabled);
+        break;
 
-        update_square(gb, 0);
-        update_square(gb, 1);
-        update_wave(gb);
-        update_noise(gb);
+    case 7: // every 8 clocks
+        update_envelope(&apu->square_waves[0].envelope);
+        update_envelope(&apu->square_waves[1].envelope);
+        update_envelope(&apu->noise.envelope);
+        break;
+    }
+}
 
-        if (apu->downsample_clock++ >= DOWNSAMPLE_DIVIDER) {
-            apu->downsample_clock = 0;
+void update_audio_sample(GameBoy *gb, const uint64_t time) {
+    APU *apu = &gb->apu;
+    schedule_event(gb, EventAudioSample, time + DOWNSAMPLE_DIVIDER);
 
-            float left = 0.0f;
-            float right = 0.0f;
+    if (!apu->enabled) {
+        return;
+    }
 
-            for (int j = 0; j < 4; ++j) {
-                if (apu->left_enabled[j]) {
-                    left += apu->channels[j];
-                }
+    sync_channels(gb, time);
 
-                if (apu->right_enabled[j]) {
-                    right += apu->channels[j];
-                }
-            }
+    output_square(gb, 0);
+    output_square(gb, 1);
+    output_wave(gb);
+    output_noise(gb);
 
-            left *= (float)gb->apu.left_volume / 7.f;
-            right *= (float)gb->apu.right_volume / 7.f;
+    float left = 0.0f;
+    float right = 0.0f;
 
-            apu->buffer[apu->buffer_position] = left / 60.0f;
-            apu->buffer[apu->buffer_position + 1] = right / 60.0f;
+    for (int j = 0; j < 4; ++j) {
+        if (apu->left_enabled[j]) {
+            left += apu->channels[j];
+        }
 
-            apu->buffer_position += AUDIO_CHANNELS;
+        if (apu->right_enabled[j]) {
+            right += apu->channels[j];
         }
     }
 
-    const size_t max_samples = apu->audio_spec.size / sizeof(float);
+    left *= (float)gb->apu.left_volume / 7.f;
+    right *= (float)gb->apu.right_volume / 7.f;
+
+    apu->buffer[apu->buffer_position] = left / 60.0f;
+    apu->buffer[apu->buffer_position + 1] = right / 60.0f;
+
+    apu->buffer_position += AUDIO_CHANNELS;
+
+    // Without a handler the samples are dropped
+    if (apu->buffer_position >= AUDIO_BUFFER_SIZE) {
+        if (apu->audio_handler != NULL) {
+            apu->audio_handler(apu->audio_user_data, apu->buffer, AUDIO_BUFFER_SIZE);
+        }
 
-    if (apu->buffer_position >= max_samples) {
-        SDL_QueueAudio(apu->device_id, apu->buffer, apu->audio_spec.size);
         apu->buffer_position = 0;
     }
 }
 
 void audio_register_write(GameBoy *gb, const uint16_t address, const uint8_t value) {
+    // Bring the channels up to date before their parameters change
+    sync_channels(gb, gb->scheduler.cycles);
+
     switch (address) {
 
     // Square Wave 1
@@ -377,10 +414,18 @@ static void read_square(GameBoy *gb, const uint16_t address, const uint8_t value
     }
 }
 
-static void update_square(GameBoy *gb, const uint8_t idx) {
+static void update_square(GameBoy *gb, const uint8_t idx, const uint32_t cycles) {
     assert(idx <= 1);
     SquareWave *square = &gb->apu.square_waves[idx];
 
+    const uint32_t steps = advance_timer(&square->clock, (2048 - square->frequency) * 4, cycles);
+    square->duty.step = (square->duty.step + steps) & 0x7;
+}
+
+static void output_square(GameBoy *gb, const uint8_t idx) {
+    assert(idx <= 1);
+    const SquareWave *square = &gb->apu.square_waves[idx];
+
     static const bool duty_table[4][8] = {
         {0, 0, 0, 0, 0, 0, 0, 1}, // 12.5%
         {1, 0, 0, 0, 0, 0, 0, 1}, // 25%
@@ -388,12 +433,6 @@ static void update_square(GameBoy *gb, const uint8_t idx) {
         {0, 1, 1, 1, 1, 1, 1, 0}  // 75%
     };
 
-    if (square->clock-- <= 0) {
-        square->clock = (2048 - square->frequency) * 4;
-        square->duty.step++;
-        square->duty.step &= 0x7;
-    }
-
     if (square->enabled && square->dac_enabled && duty_table[square->duty.mode][square->duty.step]) {
         gb->apu.channels[idx] = square->envelope.current_volume;
     } else {
@@ -417,8 +456,8 @@ static void update_square_sweep(GameBoy *gb) {
     }
 
     square->frequency = frequency;
-    SWRITE8(NR13, (frequency & 0xFF00) >> 8);
-    SWRITE8(NR14, (SREAD8(NR14) & ~CHANNEL_FREQUENCY_MSB) | ((frequency >> 8) & CHANNEL_FREQUENCY_MSB));
+    IWRITE8(NR13, (frequency & 0xFF00) >> 8);
+    IWRITE8(NR14, (IREAD8(NR14) & ~CHANNEL_FREQUENCY_MSB) | ((frequency >> 8) & CHANNEL_FREQUENCY_MSB));
 
     frequency = frequency + (frequency >> square->sweep.shift);
 
@@ -474,26 +513,25 @@ static void read_wave(GameBoy *gb, const uint16_t address, const uint8_t value)
     }
 }
 
-static void update_wave(GameBoy *gb) {
+static void update_wave(GameBoy *gb, const uint32_t cycles) {
     Wave *wave = &gb->apu.wave;
 
-    if (wave->clock-- <= 0) {
-        wave->clock = (2048 - wave->frequency) * 2;
+    const uint32_t steps = advance_timer(&wave->clock, (2048 - wave->frequency) * 2, cycles);
+    wave->position = (wave->position + steps) % 32;
+}
 
-        if (wave->position++ == 31) {
-            wave->position = 0;
-        }
-    }
+static void output_wave(GameBoy *gb) {
+    const Wave *wave = &gb->apu.wave;
 
     if (wave->enabled && wave->volume_code > 0) {
         uint8_t sample;
 
         // Top 4 bits
         if (wave->position % 2 == 0) {
-            sample = (SREAD8(WAVE_TABLE_START + wave->position) & 0xF0) >> 4;
+            sample = (IREAD8(WAVE_TABLE_START + wave->position) & 0xF0) >> 4;
             // Lower 4 bits
         } else {
-            sample = SREAD8(WAVE_TABLE_START + wave->position - 1) & 0xF;
+            sample = IREAD8(WAVE_TABLE_START + wave->position - 1) & 0xF;
         }
 
         sample = sample >> (wave->volume_code - 1);
@@ -546,45 +584,45 @@ static void read_noise(GameBoy *gb, const uint16_t address, const uint8_t value)
     }
 }
 
-static void update_noise(GameBoy *gb) {
+static void update_noise(GameBoy *gb, const uint32_t cycles) {
     Noise *noise = &gb->apu.noise;
 
     if (!noise->enabled) {
         return;
     }
 
-    if (noise->clock-- <= 0) {
-        uint8_t divisor = 0;
-
-        switch (noise->divisor_code) {
-        case 0:
-            divisor = 8;
-            break;
-        case 1:
-            divisor = 16;
-            break;
-        case 2:
-            divisor = 32;
-            break;
-        case 3:
-            divisor = 48;
-            break;
-        case 4:
-            divisor = 64;
-            break;
-        case 5:
-            divisor = 80;
-            break;
-        case 6:
-            divisor = 96;
-            break;
-        case 7:
-            divisor = 112;
-            break;
-        }
+    uint8_t divisor = 0;
 
-        noise->clock = (divisor << noise->clock_shift);
+    switch (noise->divisor_code) {
+    case 0:
+        divisor = 8;
+        break;
+    case 1:
+        divisor = 16;
+        break;
+    case 2:
+        divisor = 32;
+        break;
+    case 3:
+        divisor = 48;
+        break;
+    case 4:
+        divisor = 64;
+        break;
+    case 5:
+        divisor = 80;
+        break;
+    case 6:
+        divisor = 96;
+        break;
+    case 7:
+        divisor = 112;
+        break;
+    }
+
+    const uint32_t steps = advance_timer(&noise->clock, divisor << noise->clock_shift, cycles);
 
+    for (uint32_t i = 0; i < steps; ++i) {
         const uint8_t new_bit = (GET_BIT(noise->lfsr, 1) ^ GET_BIT(noise->lfsr, 0));
 
         noise->lfsr >>= 1;
@@ -594,9 +632,19 @@ static void update_noise(GameBoy *gb) {
             noise->lfsr &= ~(1 << 5);
             noise->lfsr |= (new_bit << 5);
         }
+    }
 
+    if (steps > 0) {
         noise->last_result = !GET_BIT(noise->lfsr, 0);
     }
+}
+
+static void output_noise(GameBoy *gb) {
+    const Noise *noise = &gb->apu.noise;
+
+    if (!noise->enabled) {
+        return;
+    }
 
     gb->apu.channels[CHANNEL_NOISE] = noise->last_result * noise->envelope.current_volume;
 }
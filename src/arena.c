@@ -0,0 +1,61 @@
+#include "arena.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef HUGE_PAGES
+#include <sys/mman.h>
+#endif
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+// Whole huge pages, the fallback to normal pages is mapped at the same size so both are unmapped alike
+#define HUGE_ARENA_SIZE ((sizeof(Arena) + HUGE_PAGE_SIZE - 1) & ~(size_t) (HUGE_PAGE_SIZE - 1))
+
+static Arena *alloc_arena(void);
+
+void init_arena(GameBoy *gb) { gb->arena = alloc_arena(); }
+
+// Zeroed and aligned to a cache line, NULL when out of memory
+static Arena *alloc_arena(void) {
+#ifdef HUGE_PAGES
+    void *pages = mmap(NULL, HUGE_ARENA_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+    // Anonymous mappings are already zeroed, fall back to normal pages when none are reserved
+    if (pages == MAP_FAILED) {
+        pages = mmap(NULL, HUGE_ARENA_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+
+    return pages == MAP_FAILED ? NULL : pages;
+#else
+    // aligned_alloc needs a multiple of the alignment
+    const size_t size = (sizeof(Arena) + ARENA_ALIGNMENT - 1) & ~(size_t) (ARENA_ALIGNMENT - 1);
+
+#ifdef _WIN32
+    Arena *arena = _aligned_malloc(size, ARENA_ALIGNMENT);
+#else
+    Arena *arena = aligned_alloc(ARENA_ALIGNMENT, size);
+#endif
+
+    if (arena != NULL) {
+        memset(arena, 0, size);
+    }
+
+    return arena;
+#endif
+}
+
+void free_arena(GameBoy *gb) {
+#if defined(HUGE_PAGES)
+    if (gb->arena != NULL) {
+        munmap(gb->arena, HUGE_ARENA_SIZE);
+    }
+#elif defined(_WIN32)
+    _aligned_free(gb->arena);
+#else
+    free(gb->arena);
+#endif
+
+    gb->arena = NULL;
+}
@@ -0,0 +1,215 @@
+#include "block.h"
+#include "cpu.h"
+#include "instr.h"
+#include "jit.h"
+#include "recomp.h"
+#include "mmu.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define CODE_MAP_SIZE ((0x10000 - CODE_MAP_START) / 8)
+
+static const uint8_t *code_source(GameBoy *, uint16_t, uint16_t *);
+#ifdef RECOMP
+static bool load_recompiled_block(GameBoy *, Block *, const uint8_t *, uint16_t);
+#endif
+static void compile_block(GameBoy *, Block *, const uint8_t *, uint16_t, uint16_t);
+static void fuse_instructions(Block *, const uint8_t *);
+static bool is_block_end(uint8_t);
+static void mark_code(GameBoy *, uint16_t, uint16_t);
+
+void init_blocks(GameBoy *gb) {
+    gb->block_cache.blocks = calloc(BLOCK_CACHE_SIZE, sizeof(Block));
+    gb->block_cache.code_map = calloc(CODE_MAP_SIZE, sizeof(uint8_t));
+    gb->block_cache.recompiled = NULL;
+    gb->block_cache.recompiled_count = 0;
+
+#ifdef JIT
+    init_jit(gb);
+#endif
+}
+
+void free_blocks(GameBoy *gb) {
+#ifdef JIT
+    free_jit(gb);
+#endif
+
+    free(gb->block_cache.blocks);
+    free(gb->block_cache.code_map);
+}
+
+void flush_blocks(GameBoy *gb) {
+    for (uint16_t i = 0; i < BLOCK_CACHE_SIZE; ++i) {
+        gb->block_cache.blocks[i].source = NULL;
+    }
+
+    memset(gb->block_cache.code_map, 0, CODE_MAP_SIZE);
+    gb->block_cache.is_stale = true;
+
+#ifdef JIT
+    gb->block_cache.code_used = 0;
+#endif
+}
+
+// Returns the block starting at PC, decoding it on a miss
+// NULL when PC is outside of ROM, work RAM and high RAM or no instruction there can be cached
+Block *find_block(GameBoy *gb) {
+    const uint16_t address = REG(PC);
+    uint16_t end;
+
+    const uint8_t *source = code_source(gb, address, &end);
+
+    if (source == NULL) {
+        return NULL;
+    }
+
+    Block *block = &gb->block_cache.blocks[((uintptr_t) source) & (BLOCK_CACHE_SIZE - 1)];
+
+    if (block->source != source || block->address != address) {
+#ifdef RECOMP
+        // Rom code compiled ahead of time is not decoded at all
+        if (address <= ROMNN_END && gb->block_cache.recompiled_count > 0 &&
+            load_recompiled_block(gb, block, source, address)) {
+            return block;
+        }
+#endif
+
+        compile_block(gb, block, source, address, end);
+    }
+
+    return block->length > 0 || block->code != NULL ? block : NULL;
+}
+
+// Host address of the code at address, end is the first address past its memory region
+static const uint8_t *code_source(GameBoy *gb, const uint16_t address, uint16_t *end) {
+    if (address <= ROM00_END) {
+        *end = ROMNN_START;
+        return gb->mmu.rom00 + address;
+    } else if (address <= ROMNN_END) {
+        *end = VRAM_START;
+        return gb->mmu.romNN + (address - ROMNN_START);
+    } else if (address >= WRAM00_START && address <= WRAM00_END) {
+        *end = WRAMNN_START;
+        return gb->mmu.wram00 + (address - WRAM00_START);
+    } else if (address >= WRAMNN_START && address <= WRAMNN_END) {
+        *end = WRAM00_MIRROR_START;
+        return gb->mmu.wramNN + (address - WRAMNN_START);
+    } else if (address >= HRAM_START && address <= HRAM_END) {
+        *end = IE_START_END;
+        return gb->mmu.hram + (address - HRAM_START);
+    }
+
+    return NULL;
+}
+
+#ifdef RECOMP
+
+// Looks the block up by the rom bank mapped at address, it keeps no decoded instructions
+static bool load_recompiled_block(GameBoy *gb, Block *block, const uint8_t *source, const uint16_t address) {
+    const uint16_t bank = address <= ROM00_END ? gb->mmu.rom00_bank : gb->mmu.rom_bank;
+    const BlockCode code = find_recompiled(gb, bank, address);
+
+    if (code == NULL) {
+        return false;
+    }
+
+    block->source = source;
+    block->address = address;
+    block->length = 0;
+    block->hits = 0;
+    block->code = code;
+
+    return true;
+}
+
+#endif
+
+// Decodes instructions up to the first branch, operands are read ahead of time
+static void compile_block(GameBoy *gb, Block *block, const uint8_t *source, const uint16_t start,
+                          const uint16_t end) {
+    uint16_t address = start;
+
+    block->source = source;
+    block->address = start;
+    block->length = 0;
+    block->hits = 0;
+    block->code = NULL;
+
+    while (block->length < BLOCK_MAX_LENGTH && address < end) {
+        const uint8_t *bytes = source + (address - start);
+
+        // Switches the CPU speed, left to the interpreter
+        if (bytes[0] == 0x10) {
+            break;
+        }
+
+        // Instructions may not straddle two memory regions
+        const uint8_t length = bytes[0] == 0xCB ? 2 : find_instr(gb, address)->length;
+
+        if (address + length > end) {
+            break;
+        }
+
+        BlockInstruction *instr = &block->instructions[block->length++];
+        instr->handler = opcode_handlers[bytes[0]];
+        instr->opcode = bytes[0];
+        instr->operand = length == 3 ? bytes[1] | (bytes[2] << 8) : length == 2 ? bytes[1] : 0;
+        instr->length = length;
+        instr->fusion = FusionNone;
+
+        address += length;
+
+        if (is_block_end(bytes[0])) {
+            break;
+        }
+    }
+
+    fuse_instructions(block, source);
+
+    if (start >= WRAM00_START) {
+        mark_code(gb, start, address);
+    }
+}
+
+static void fuse_instructions(Block *block, const uint8_t *source) {
+    const uint8_t *bytes = source;
+
+    for (uint8_t i = 0; i + 1 < block->length; ++i) {
+        const uint8_t opcode = bytes[0];
+        const uint8_t next_opcode = bytes[block->instructions[i].length];
+
+        // DEC r followed by JR NZ, r8
+        if ((opcode & 0xC7) == 0x05 && opcode != 0x35 && next_opcode == 0x20) {
+            block->instructions[i].fusion = FusionDecJrNz;
+        }
+        // LD A, (HL+) followed by CP d8
+        else if (opcode == 0x2A && next_opcode == 0xFE) {
+            block->instructions[i].fusion = FusionLoadCompare;
+        }
+
+        bytes += block->instructions[i].length;
+    }
+}
+
+// Jumps, calls, returns and HALT
+static bool is_block_end(const uint8_t opcode) {
+    switch (opcode) {
+    case 0x18: case 0x20: case 0x28: case 0x30: case 0x38:
+    case 0xC2: case 0xC3: case 0xCA: case 0xD2: case 0xDA: case 0xE9:
+    case 0xC4: case 0xCC: case 0xCD: case 0xD4: case 0xDC:
+    case 0xC0: case 0xC8: case 0xC9: case 0xD0: case 0xD8: case 0xD9:
+    case 0xC7: case 0xCF: case 0xD7: case 0xDF: case 0xE7: case 0xEF: case 0xF7: case 0xFF:
+    case 0x76:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+static void mark_code(GameBoy *gb, const uint16_t start, const uint16_t end) {
+    for (uint32_t address = start; address < end; ++address) {
+        const uint16_t index = address - CODE_MAP_START;
+        gb->block_cache.code_map[index >> 3] |= 1 << (index & 7);
+    }
+}
@@ -1,4 +1,7 @@
 #include "cart.h"
+#include "arena.h"
+#include "block.h"
+#include "macro.h"
 #include "mbc.h"
 #include "mmu.h"
 #include <assert.h>
@@ -6,38 +9,72 @@
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#ifdef MAPPED_ROM
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 #define STR_COPY_APPEND(buffer, filename, ext)                                                                         \
     {                                                                                                                  \
         strcpy((buffer), (filename));                                                                                  \
         strcat((buffer), (ext));                                                                                       \
     }
 
-static void parse_header(GameBoy *, const uint8_t *);
+static void parse_header(CartImage *, const uint8_t *);
 static bool read_header(FILE *file, uint8_t *);
+static bool map_rom(CartImage *, FILE *);
 static void alloc_banks(GameBoy *);
-static void copy_data(GameBoy *, FILE *);
-static void set_banks(GameBoy *);
+static uint32_t add_reference(CartImage *, int32_t);
 
 bool load_rom(GameBoy *gb, const char *path) {
+    CartImage *image = load_cart_image(path);
+
+    if (image == NULL) {
+        return false;
+    }
+
+    attach_cart(gb, image);
+    release_cart_image(image);
+    return true;
+}
+
+// The caller holds the only reference to the new image
+CartImage *load_cart_image(const char *path) {
     FILE *file = fopen(path, "rb");
 
     if (file == NULL) {
-        return false;
+        return NULL;
     }
 
     uint8_t header[CART_HEADER_SIZE];
 
     if (!read_header(file, header)) {
         fclose(file);
-        return false;
+        return NULL;
+    }
+
+    CartImage *image = calloc(1, sizeof(CartImage));
+    image->references = 1;
+    parse_header(image, header);
+
+    if (!map_rom(image, file)) {
+        fclose(file);
+        free(image);
+        return NULL;
     }
 
-    parse_header(gb, header);
-    alloc_banks(gb);
-    copy_data(gb, file);
-    set_banks(gb);
     fclose(file);
 
+    image->rom_banks = malloc(sizeof(uint8_t *) * image->rom_size);
+
+    for (uint16_t i = 0; i < image->rom_size; ++i) {
+        image->rom_banks[i] = image->rom + i * ROM_BANK_SIZE;
+    }
+
 #ifdef _WIN32
     const char sep = '\\';
 #else
@@ -47,64 +84,153 @@ bool load_rom(GameBoy *gb, const char *path) {
     char *last_sep = strrchr(path, sep);
 
     if (last_sep != NULL) {
-        strcpy(gb->cart.filename, strrchr(path, sep) + sizeof(char));
+        strcpy(image->filename, strrchr(path, sep) + sizeof(char));
     } else {
-        strcpy(gb->cart.filename, path);
+        strcpy(image->filename, path);
     }
 
-    load_ram(gb);
-    return true;
+    return image;
 }
 
+void release_cart_image(CartImage *image) {
+    if (add_reference(image, -1) > 0) {
+        return;
+    }
+
+#ifdef MAPPED_ROM
+    munmap(image->rom, (size_t)image->rom_size * ROM_BANK_SIZE);
+#else
+    free(image->rom);
+#endif
+
+    free(image->rom_banks);
+    free(image);
+}
+
+// Only the ram and the bank registers belong to the instance, the rom is read from the image
+void attach_cart(GameBoy *gb, CartImage *image) {
+    add_reference(image, 1);
+
+    gb->cart.image = image;
+
+    alloc_banks(gb);
+    reset_mbc(gb);
+}
+
+void detach_cart(GameBoy *gb) {
+    gb->mmu.mbc = NULL;
+    gb->mmu.rom00 = NULL;
+    gb->mmu.romNN = NULL;
+    gb->mmu.extram = NULL;
+    update_pages(gb);
+
+    // Cached blocks point into the rom
+    flush_blocks(gb);
+
+    release_cart_image(gb->cart.image);
+    gb->cart.image = NULL;
+}
+
+// Every ram bank is kept, older saves and banks never written may be missing from the end
 bool load_ram(GameBoy *gb) {
-    if (gb->cart.ram_size == 0) {
+    const size_t size = (size_t)gb->cart.image->ram_size * EXTRAM_BANK_SIZE;
+
+    if (size == 0) {
         return true;
     }
 
-    char filename[256 + 5];
-    STR_COPY_APPEND(filename, gb->cart.filename, ".save");
+    char filename[256 + sizeof(SAVE_EXTENSION)];
+    STR_COPY_APPEND(filename, gb->cart.image->filename, SAVE_EXTENSION);
     FILE *file = fopen(filename, "rb");
 
     if (file == NULL) {
         return true;
     }
 
-    uint8_t *buffer = malloc(EXTRAM_BANK_SIZE * sizeof(uint8_t));
-    size_t bytes_read = fread(buffer, sizeof(uint8_t), EXTRAM_BANK_SIZE, file);
+    uint8_t *buffer = malloc(size * sizeof(uint8_t));
+    size_t bytes_read = fread(buffer, sizeof(uint8_t), size, file);
     fclose(file);
 
-    if (bytes_read != EXTRAM_BANK_SIZE) {
+    if (bytes_read % EXTRAM_BANK_SIZE != 0) {
         free(buffer);
         return false;
     }
 
-    memcpy(gb->cart.ram_banks[0], buffer, EXTRAM_BANK_SIZE);
+    for (size_t i = 0; i < bytes_read / EXTRAM_BANK_SIZE; ++i) {
+        memcpy(gb->cart.ram_banks[i], buffer + i * EXTRAM_BANK_SIZE, EXTRAM_BANK_SIZE);
+    }
+
     free(buffer);
     return true;
 }
 
+// Writes only the banks changed since the last save
 void save_ram(GameBoy *gb) {
-
-    if (gb->cart.ram_size == 0) {
+    if (gb->cart.image->ram_size == 0) {
         return;
     }
 
-    char filename[256 + 5];
-    STR_COPY_APPEND(filename, gb->cart.filename, ".save");
-    FILE *file = fopen(filename, "wb");
+    char filename[256 + sizeof(SAVE_EXTENSION)];
+    STR_COPY_APPEND(filename, gb->cart.image->filename, SAVE_EXTENSION);
 
-    if (file != NULL) {
-        fwrite(gb->cart.ram_banks[0], sizeof(uint8_t), EXTRAM_BANK_SIZE, file);
-        fclose(file);
+    const uint16_t dirty_banks = take_dirty_ram(gb);
+
+    if (!write_ram_banks(filename, gb->cart.ram_banks, dirty_banks)) {
+        gb->cart.dirty_banks |= dirty_banks;
     }
 }
 
+// Banks written since the last call, their next write takes the slow path again to mark them
+uint16_t take_dirty_ram(GameBoy *gb) {
+    const uint16_t dirty_banks = gb->cart.dirty_banks;
+
+    if (dirty_banks != 0) {
+        gb->cart.dirty_banks = 0;
+        update_pages(gb);
+    }
+
+    return dirty_banks;
+}
+
+// Writes the banks in the mask at their place in the save file, the others are left as they are
+// Only reads the banks, so another thread can write a copy of them
+bool write_ram_banks(const char *filename, uint8_t *const *banks, const uint16_t mask) {
+    if (mask == 0) {
+        return true;
+    }
+
+    FILE *file = fopen(filename, "r+b");
+
+    if (file == NULL) {
+        file = fopen(filename, "w+b");
+    }
+
+    if (file == NULL) {
+        return false;
+    }
+
+    bool is_written = true;
+
+    for (uint8_t i = 0; i < EXTRAM_BANK_COUNT; ++i) {
+        if (GET_BIT(mask, i) == 0) {
+            continue;
+        }
+
+        if (fseek(file, (long) i * EXTRAM_BANK_SIZE, SEEK_SET) != 0 ||
+            fwrite(banks[i], sizeof(uint8_t), EXTRAM_BANK_SIZE, file) != EXTRAM_BANK_SIZE) {
+            is_written = false;
+        }
+    }
+
+    return fclose(file) == 0 && is_written;
+}
+
 void print_cart_info(GameBoy *gb) {
-    printf("Title: %s\n", gb->cart.title);
-    printf("Colour: %s\n", gb->cart.is_colour ? "yes" : "no");
-    printf("Cartridge Type: %02X\n", gb->cart.type);
-    printf("ROM Size: %d x %d KB\n", gb->cart.rom_size, ROM_BANK_SIZE);
-    printf("RAM Size: %d x %d KB\n", gb->cart.ram_size, EXTRAM_BANK_SIZE);
+    printf("Title: %s\n", gb->cart.image->title);
+    printf("Colour: %s\n", gb->cart.image->is_colour ? "yes" : "no");
+    printf("Cartridge Type: %02X\n", gb->cart.image->type);
+    printf("ROM Size: %d x %d KB\n", gb->cart.image->rom_size, ROM_BANK_SIZE);
+    printf("RAM Size: %d x %d KB\n", gb->cart.image->ram_size, EXTRAM_BANK_SIZE);
 }
 
 static bool read_header(FILE *file, uint8_t *header) {
@@ -125,49 +251,55 @@ static bool read_header(FILE *file, uint8_t *header) {
     return true;
 }
 
-static void parse_header(GameBoy *gb, const uint8_t *header) {
+static void parse_header(CartImage *image, const uint8_t *header) {
 #define HEADER(addr) header[(addr)-CART_HEADER_START]
 
-    memcpy(gb->cart.title, &HEADER(CART_HEADER_TITLE), 16);
-    gb->cart.title[16] = '\0';
+    memcpy(image->title, &HEADER(CART_HEADER_TITLE), 16);
+    image->title[16] = '\0';
 
     const uint8_t gbc_flag = HEADER(CART_HEADER_GBC_FLAG);
-    gb->cart.is_colour = gbc_flag == CART_HEADER_GBC_ONLY;
+    image->is_colour = gbc_flag == CART_HEADER_GBC_ONLY;
 
-    gb->cart.type = HEADER(CART_HEADER_TYPE);
-    gb->cart.rom_size = (2 * ROM_BANK_SIZE << HEADER(CART_HEADER_ROM_SIZE)) / ROM_BANK_SIZE; // 32KB sl N
+    image->type = HEADER(CART_HEADER_TYPE);
+    image->rom_size = (2 * ROM_BANK_SIZE << HEADER(CART_HEADER_ROM_SIZE)) / ROM_BANK_SIZE; // 32KB sl N
 
     switch (HEADER(CART_HEADER_RAM_SIZE)) {
     case 0x0:
-        gb->cart.ram_size = 0;
+        image->ram_size = 0;
         break;
     case 0x1:
     case 0x2:
-        gb->cart.ram_size = 1;
+        image->ram_size = 1;
         break;
     case 0x3:
-        gb->cart.ram_size = 4;
+        image->ram_size = 4;
         break;
     case 0x4:
-        gb->cart.ram_size = 16;
+        image->ram_size = 16;
         break;
     case 0x5:
-        gb->cart.ram_size = 8;
+        image->ram_size = 8;
         break;
     }
 
 #undef HEADER
 
-    switch (gb->cart.type) {
+    switch (image->type) {
     case 0x1:
     case 0x2:
     case 0x3:
-        gb->mmu.mbc_handler = &mbc1_handler;
+    // MBC4 carts were never released
+    case 0x15:
+    case 0x16:
+    case 0x17:
+        image->mbc = &mbc1;
         break;
 
+    // The half byte ram is built into the MBC, a bank holds it
     case 0x5:
     case 0x6:
-        gb->mmu.mbc_handler = &mbc2_handler;
+        image->mbc = &mbc2;
+        image->ram_size = 1;
         break;
 
     case 0xF:
@@ -175,13 +307,7 @@ static void parse_header(GameBoy *gb, const uint8_t *header) {
     case 0x11:
     case 0x12:
     case 0x13:
-        gb->mmu.mbc_handler = &mbc3_handler;
-        break;
-
-    case 0x15:
-    case 0x16:
-    case 0x17:
-        gb->mmu.mbc_handler = &mbc4_handler;
+        image->mbc = &mbc3;
         break;
 
     case 0x19:
@@ -190,49 +316,99 @@ static void parse_header(GameBoy *gb, const uint8_t *header) {
     case 0x1C:
     case 0x1D:
     case 0x1E:
-        gb->mmu.mbc_handler = &mbc5_handler;
+        image->mbc = &mbc5;
         break;
 
     default:
-        gb->mmu.mbc_handler = NULL;
+        image->mbc = NULL;
         break;
     }
 }
 
+// The ram banks are in the arena
 static void alloc_banks(GameBoy *gb) {
-    gb->cart.rom_banks = malloc(sizeof(uint8_t *) * gb->cart.rom_size);
+    gb->cart.dirty_banks = 0;
+    memset(gb->arena->extram, 0, sizeof(gb->arena->extram));
+
+    for (uint8_t i = 0; i < EXTRAM_BANK_COUNT; ++i) {
+        gb->cart.ram_banks[i] = i < gb->cart.image->ram_size ? gb->arena->extram[i] : NULL;
+    }
+}
+
+// Maps the whole rom read only, its pages are shared with every other process running it
+// Past the end of a short file, the banks read as zeroes
+static bool map_rom(CartImage *image, FILE *file) {
+    assert(file != NULL);
+
+    const size_t size = (size_t)image->rom_size * ROM_BANK_SIZE;
+
+    fseek(file, 0, SEEK_END);
+    const long file_size = ftell(file);
+    fseek(file, 0, SEEK_SET);
 
-    for (uint16_t i = 0; i < gb->cart.rom_size; ++i) {
-        gb->cart.rom_banks[i] = calloc(ROM_BANK_SIZE, sizeof(uint8_t));
+    if (file_size < 0) {
+        return false;
     }
 
-    gb->cart.ram_banks = NULL;
+#ifdef MAPPED_ROM
+    const int fd = fileno(file);
 
-    if (gb->cart.ram_size > 0) {
-        gb->cart.ram_banks = malloc(sizeof(uint8_t *) * gb->cart.ram_size);
+    if ((size_t)file_size >= size) {
+        uint8_t *rom = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
 
-        for (uint8_t i = 0; i < gb->cart.ram_size; ++i) {
-            gb->cart.ram_banks[i] = calloc(EXTRAM_BANK_SIZE, sizeof(uint8_t));
+        if (rom == MAP_FAILED) {
+            return false;
         }
+
+        image->rom = rom;
+        return true;
     }
-}
 
-static void copy_data(GameBoy *gb, FILE *file) {
-    assert(file != NULL);
-    int32_t byte;
-    uint32_t position = 0;
+    // The whole pages of the file are mapped over zeroed memory, only the partial one at the end is copied
+    uint8_t *rom = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
 
-    while ((byte = fgetc(file)) != EOF) {
-        const uint16_t bank = position / ROM_BANK_SIZE;
-        gb->cart.rom_banks[bank][position - (ROM_BANK_SIZE * bank)] = (uint8_t)byte;
-        position++;
+    if (rom == MAP_FAILED) {
+        return false;
     }
-}
 
-static void set_banks(GameBoy *gb) {
-    gb->mmu.ram_bank = -1;
-    gb->mmu.rom_bank = 1;
+    const size_t page_size = sysconf(_SC_PAGESIZE);
+    const size_t mapped = file_size / page_size * page_size;
+    const size_t tail = file_size - mapped;
+
+    if (mapped > 0 && mmap(rom, mapped, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        munmap(rom, size);
+        return false;
+    }
+
+    fseek(file, mapped, SEEK_SET);
+
+    if (fread(rom + mapped, sizeof(uint8_t), tail, file) != tail) {
+        munmap(rom, size);
+        return false;
+    }
+
+    mprotect(rom + mapped, size - mapped, PROT_READ);
+    image->rom = rom;
+    return true;
+#else
+    // Anything past the size in the header is not addressable
+    const size_t length = (size_t)file_size < size ? (size_t)file_size : size;
+    image->rom = calloc(image->rom_size, ROM_BANK_SIZE);
+
+    if (fread(image->rom, sizeof(uint8_t), length, file) != length) {
+        free(image->rom);
+        return false;
+    }
 
-    gb->mmu.rom00 = gb->cart.rom_banks[0];
-    gb->mmu.romNN = gb->cart.rom_banks[1];
+    return true;
+#endif
+}
+
+// Instances may attach and detach from different threads
+static uint32_t add_reference(CartImage *image, const int32_t delta) {
+#ifdef _MSC_VER
+    return _InterlockedExchangeAdd((volatile long *)&image->references, delta) + delta;
+#else
+    return __atomic_add_fetch(&image->references, delta, __ATOMIC_ACQ_REL);
+#endif
 }
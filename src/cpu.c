@@ -1,11 +1,27 @@
+#include "alu.h"
+#include "block.h"
 #include "cpu.h"
 #include "instr.h"
+#include "jit.h"
 #include "macro.h"
 #include "mmu.h"
+#include "scheduler.h"
 #include <assert.h>
 
+static inline uint8_t fetch_program(GameBoy *, uint16_t);
+static uint8_t refill_fetch(GameBoy *, uint16_t);
+static void execute_instruction(GameBoy *);
+static void skip_halt(GameBoy *);
+static bool is_idle_loop_body(GameBoy *, uint16_t, uint16_t);
+static bool is_timer_register(uint16_t);
 static void service_interrupt(GameBoy *, uint8_t);
+static uint8_t timer_bit(GameBoy *);
+static uint32_t timer_period(GameBoy *);
+static uint8_t current_tima(GameBoy *);
+static void sync_tima(GameBoy *);
+static void schedule_overflow(GameBoy *);
 static void increment_tima(GameBoy *);
+static uint32_t timer_interrupt_ticks(GameBoy *);
 
 void reset_cpu(GameBoy *gb) {
     REG(AF) = 0x11B0;
@@ -15,85 +31,522 @@ void reset_cpu(GameBoy *gb) {
     REG(PC) = PROGRAM_START;
     REG(SP) = 0xFFFE;
     REG(IME) = false;
+    gb->cpu.flags.op = FlagsEvaluated;
+    gb->cpu.pending_interrupts = 0;
+    gb->cpu.fetch.length = 0;
+    gb->cpu.is_operand_decoded = false;
+    gb->cpu.decoded_operand = 0;
 
     gb->cpu.is_halted = false;
     gb->cpu.is_double_speed = false;
 
-    gb->cpu.div = 0;
-    gb->cpu.div_overflow = false;
-    gb->cpu.div_overflow_ticks = 0;
+    // TAC is cleared with the other IO registers, the timer starts stopped
+    gb->cpu.timer.clock = 0;
+    gb->cpu.timer.next_update = UINT64_MAX;
+    gb->cpu.timer.div_clock = 0;
+    gb->cpu.timer.tima_clock = 0;
+    gb->cpu.timer.overflow_clock = UINT64_MAX;
+    gb->cpu.timer.tima = 0;
+    gb->cpu.timer.is_overflow_pending = false;
+
+    gb->cpu.idle_loop.address = 0;
+    gb->cpu.idle_loop.is_pure = false;
 }
 
 /*
     Instructions
 */
 
-Instruction find_instr(GameBoy *gb, const uint16_t address) {
+const Instruction *find_instr(GameBoy *gb, const uint16_t address) {
     const uint8_t opcode = SREAD8(address);
 
     if (opcode == 0xCB) {
         const uint8_t next_opcode = SREAD8(address + 1);
-        return cb_instructions[next_opcode];
+        return &cb_instructions[next_opcode];
     } else {
-        return instructions[opcode];
+        return &instructions[opcode];
     }
 }
 
-void update_cpu(GameBoy *gb) {
-    gb->cpu.ticks = CPU_STEP;
-    tick_timer(gb, CPU_STEP);
+uint8_t fetch_byte(GameBoy *gb) {
+    const uint8_t value = gb->cpu.is_operand_decoded ? gb->cpu.decoded_operand : fetch_program(gb, REG(PC));
+    REG(PC)++;
+    TICK(1);
+
+    return value;
+}
+
+uint16_t fetch_short(GameBoy *gb) {
+    uint16_t value = gb->cpu.decoded_operand;
+
+    if (!gb->cpu.is_operand_decoded) {
+        value = fetch_program(gb, REG(PC));
+        value |= fetch_program(gb, REG(PC) + 1) << 8;
+    }
+
+    REG(PC) += 2;
+    TICK(2);
+
+    return value;
+}
+
+// Reads code at address, a plain load while it stays in the cached page
+static inline uint8_t fetch_program(GameBoy *gb, const uint16_t address) {
+    const uint16_t offset = address - gb->cpu.fetch.start;
+
+    if (offset < gb->cpu.fetch.length) {
+        return gb->cpu.fetch.memory[offset];
+    }
+
+    return refill_fetch(gb, address);
+}
+
+// Caches the page of address, code in pages without host memory is read through the bus
+static uint8_t refill_fetch(GameBoy *gb, const uint16_t address) {
+    const uint8_t *page = gb->mmu.read_pages[address >> MMU_PAGE_SHIFT];
+
+    if (page == NULL) {
+        gb->cpu.fetch.length = 0;
+        return READ8(address);
+    }
+
+    gb->cpu.fetch.memory = page;
+    gb->cpu.fetch.start = address & ~0xFF;
+    gb->cpu.fetch.length = 1 << MMU_PAGE_SHIFT;
+
+    return page[address & 0xFF];
+}
 
+void update_cpu(GameBoy *gb) {
     if (gb->cpu.is_halted) {
-        return;
+        skip_halt(gb);
+    } else {
+        gb->cpu.ticks = CPU_STEP;
+        tick_timer(gb, CPU_STEP);
+        execute_instruction(gb);
     }
 
-    const Instruction instruction = find_instr(gb, REG(PC));
-    uint8_t operand_len = instruction.length - 1;
+    // In double speed mode the CPU runs two clocks for every clock of the other components
+    gb->scheduler.cycles += gb->cpu.ticks >> gb->cpu.is_double_speed;
+}
+
+// Nothing can wake the CPU before the next visible event or timer interrupt
+// Jump there directly instead of stepping one machine cycle at a time
+static void skip_halt(GameBoy *gb) {
+    const uint8_t step_cycles = CPU_STEP >> gb->cpu.is_double_speed;
+    const uint64_t deadline = next_sync_time(gb);
+
+    uint32_t steps = 1;
+
+    if (deadline > gb->scheduler.cycles && gb->cpu.pending_interrupts == 0) {
+        steps = (deadline - gb->scheduler.cycles + step_cycles - 1) / step_cycles;
+    }
+
+    if (RREG(IE, IEF_TIMER)) {
+        const uint32_t timer_steps = ((uint64_t) timer_interrupt_ticks(gb) + CPU_STEP - 1) / CPU_STEP;
+
+        if (timer_steps < steps) {
+            steps = timer_steps;
+        }
+    }
 
-    if (instruction.extended) {
-        operand_len--;
-        TICK(1);
+    if (steps == 0) {
+        steps = 1;
     }
 
+    gb->cpu.ticks = steps * CPU_STEP;
+    tick_timer(gb, gb->cpu.ticks);
+
+    gb->stats.halt_skipped_cycles += gb->cpu.ticks - CPU_STEP;
+}
+
+// Handlers fetch their own operands, the opcode is fetched here
+static void execute_instruction(GameBoy *gb) {
     const uint16_t instr_start = REG(PC);
-    REG(PC) += instruction.length;
+    const uint8_t opcode = fetch_program(gb, instr_start);
+    REG(PC)++;
 
-    switch (operand_len) {
-    case 0: {
-        const void (*opcode_function)(GameBoy *) = instruction.execute;
-        opcode_function(gb);
-        break;
+    opcode_handlers[opcode](gb);
+    gb->stats.instructions++;
+
+    if (REG(PC) < instr_start && instr_start - REG(PC) < IDLE_LOOP_MAX_LENGTH) {
+        check_idle_loop(gb, instr_start);
     }
+}
 
-    case 1: {
-        const uint8_t operand = SREAD8(instr_start + 1);
-        TICK(1);
+#ifdef BLOCK_CACHE
 
-        const void (*opcode_function)(GameBoy *, const uint8_t) = instruction.execute;
-        opcode_function(gb, operand);
-        break;
+// Runs the instructions of a block exactly like the interpreter would, without fetching them from memory
+static void run_block(GameBoy *gb, Block *block) {
+    const BlockInstruction *instr = block->instructions;
+    const BlockInstruction *end = instr + block->length;
+
+    gb->block_cache.is_stale = false;
+    gb->cpu.is_operand_decoded = true;
+
+#ifdef JIT
+    if (block->code == NULL && ++block->hits == JIT_THRESHOLD) {
+        compile_jit(gb, block);
     }
+#endif
 
-    case 2: {
-        const uint16_t operand = SREAD16(instr_start + 1);
-        TICK(2);
+    // Machine code compiled at runtime or ahead of time
+    if (block->code != NULL) {
+        block->code(gb);
+        gb->cpu.is_operand_decoded = false;
+        return;
+    }
 
-        const void (*opcode_function)(GameBoy *, const uint16_t) = instruction.execute;
-        opcode_function(gb, operand);
-        break;
+    for (; instr < end; ++instr) {
+        uint16_t instr_start = REG(PC);
+        begin_block_instruction(gb, instr->operand);
+        instr->handler(gb);
+
+        switch (instr->fusion) {
+        case FusionNone:
+            break;
+
+        // The decrement is still the pending flag operation, Z is set when it started from 1
+        case FusionDecJrNz:
+            if (!end_block_instruction(gb, instr_start, instr->length)) {
+                gb->cpu.is_operand_decoded = false;
+                return;
+            }
+
+            instr_start = REG(PC);
+            ++instr;
+            begin_block_instruction(gb, instr->operand);
+            REG(PC)++;
+            TICK(1);
+
+            if (gb->cpu.flags.a != 1) {
+                REG(PC) += (int8_t) instr->operand;
+                TICK(1);
+            }
+            break;
+
+        case FusionLoadCompare:
+            if (!end_block_instruction(gb, instr_start, instr->length)) {
+                gb->cpu.is_operand_decoded = false;
+                return;
+            }
+
+            instr_start = REG(PC);
+            ++instr;
+            begin_block_instruction(gb, instr->operand);
+            REG(PC)++;
+            TICK(1);
+
+            sub_byte(gb, REG(A), instr->operand);
+            break;
+        }
+
+        if (!end_block_instruction(gb, instr_start, instr->length)) {
+            break;
+        }
     }
 
-    default:
-        ASSERT_NOT_REACHED();
+    gb->cpu.is_operand_decoded = false;
+}
+
+// Leaves the interpreter as soon as PC is back in memory with cached blocks
+#define IS_BLOCK_CODE(address)                                                                                         \
+    ((address) <= ROMNN_END || ((address) >= WRAM00_START && (address) <= WRAMNN_END) ||                               \
+     ((address) >= HRAM_START && (address) <= HRAM_END))
+
+#else
+
+#define IS_BLOCK_CODE(address) false
+
+#endif
+
+#ifdef THREADED_DISPATCH
+
+#define OPCODE_ROW(M, h)                                                                                               \
+    M(0x##h##0) M(0x##h##1) M(0x##h##2) M(0x##h##3) M(0x##h##4) M(0x##h##5) M(0x##h##6) M(0x##h##7) M(0x##h##8)       \
+    M(0x##h##9) M(0x##h##A) M(0x##h##B) M(0x##h##C) M(0x##h##D) M(0x##h##E) M(0x##h##F)
+
+#define ALL_OPCODES(M)                                                                                                 \
+    OPCODE_ROW(M, 0) OPCODE_ROW(M, 1) OPCODE_ROW(M, 2) OPCODE_ROW(M, 3) OPCODE_ROW(M, 4) OPCODE_ROW(M, 5)             \
+    OPCODE_ROW(M, 6) OPCODE_ROW(M, 7) OPCODE_ROW(M, 8) OPCODE_ROW(M, 9) OPCODE_ROW(M, A) OPCODE_ROW(M, B)             \
+    OPCODE_ROW(M, C) OPCODE_ROW(M, D) OPCODE_ROW(M, E) OPCODE_ROW(M, F)
+
+#define OPCODE_LABEL_ADDRESS(n) &&opcode_##n,
+
+// Same sequence as update_cpu followed by check_interrupts
+#define BEGIN_INSTRUCTION()                                                                                            \
+    {                                                                                                                  \
+        gb->cpu.ticks = CPU_STEP;                                                                                      \
+        tick_timer(gb, CPU_STEP);                                                                                      \
+        instr_start = REG(PC);                                                                                         \
+        opcode = fetch_program(gb, instr_start);                                                                       \
+        REG(PC)++;                                                                                                     \
+    }
+
+#define END_INSTRUCTION()                                                                                              \
+    {                                                                                                                  \
+        gb->stats.instructions++;                                                                                      \
+                                                                                                                       \
+        if (REG(PC) < instr_start && instr_start - REG(PC) < IDLE_LOOP_MAX_LENGTH) {                                   \
+            check_idle_loop(gb, instr_start);                                                                          \
+        }                                                                                                              \
+                                                                                                                       \
+        gb->scheduler.cycles += gb->cpu.ticks >> gb->cpu.is_double_speed;                                              \
+        check_interrupts(gb);                                                                                          \
+    }
+
+// Every opcode gets its own copy of the dispatch jump, the handler call is direct
+#define OPCODE_LABEL(n)                                                                                                \
+    opcode_##n : opcode_handlers[n](gb);                                                                          \
+    END_INSTRUCTION();                                                                                                 \
+                                                                                                                       \
+    if (gb->scheduler.cycles >= gb->scheduler.deadline || gb->cpu.is_halted || IS_BLOCK_CODE(REG(PC))) {              \
+        continue;                                                                                                      \
+    }                                                                                                                  \
+                                                                                                                       \
+    BEGIN_INSTRUCTION();                                                                                               \
+    goto *labels[opcode];
+
+#endif
+
+// Runs the CPU until the deadline, interrupts are checked after every instruction
+// Scheduling an earlier event during the run moves the deadline of the scheduler
+void run_cpu(GameBoy *gb, const uint64_t deadline) {
+    gb->scheduler.deadline = deadline;
+
+#ifdef THREADED_DISPATCH
+    static const void *const labels[INSTRUCTION_COUNT] = {ALL_OPCODES(OPCODE_LABEL_ADDRESS)};
+
+    uint16_t instr_start;
+    uint8_t opcode;
+
+    while (gb->scheduler.cycles < gb->scheduler.deadline) {
+        if (gb->cpu.is_halted) {
+            update_cpu(gb);
+            check_interrupts(gb);
+            continue;
+        }
+
+#ifdef BLOCK_CACHE
+        Block *block = find_block(gb);
+
+        if (block != NULL) {
+            run_block(gb, block);
+            continue;
+        }
+#endif
+
+        BEGIN_INSTRUCTION();
+        goto *labels[opcode];
+
+        ALL_OPCODES(OPCODE_LABEL)
+    }
+#else
+    while (gb->scheduler.cycles < gb->scheduler.deadline) {
+#ifdef BLOCK_CACHE
+        Block *block = gb->cpu.is_halted ? NULL : find_block(gb);
+
+        if (block != NULL) {
+            run_block(gb, block);
+            continue;
+        }
+#endif
+
+        update_cpu(gb);
+        check_interrupts(gb);
+    }
+#endif
+}
+
+/*
+    Idle loops
+*/
+
+// Checks the loop of a branch which went back to a close address
+void check_idle_branch(GameBoy *gb, const uint16_t instr_start) {
+    if (REG(PC) < instr_start && instr_start - REG(PC) < IDLE_LOOP_MAX_LENGTH) {
+        check_idle_loop(gb, instr_start);
+    }
+}
+
+// Called on every short backward branch
+// A side effect free loop which reaches its head twice with the same registers will
+// keep spinning until an event or interrupt changes the memory it polls, skip whole iterations until then
+void check_idle_loop(GameBoy *gb, const uint16_t branch) {
+    const uint64_t now = gb->scheduler.cycles + (gb->cpu.ticks >> gb->cpu.is_double_speed);
+    const uint32_t timer_ticks = timer_interrupt_ticks(gb);
+    uint64_t deadline = next_sync_time(gb);
+
+    // The loop may be polling IF, the TIMA overflow sets it whether or not the interrupt is enabled
+    // An overflow during the last iteration moves the deadline and the loop is checked again
+    if (timer_ticks != UINT32_MAX && now + (timer_ticks >> gb->cpu.is_double_speed) < deadline) {
+        deadline = now + (timer_ticks >> gb->cpu.is_double_speed);
+    }
+
+    const Registers *reg = &gb->cpu.idle_loop.reg;
+    evaluate_flags(gb);
+
+    const bool is_same_loop = gb->cpu.idle_loop.address == REG(PC) && gb->cpu.idle_loop.deadline == deadline;
+    const bool is_same_state = REG(AF) == reg->AF && REG(BC) == reg->BC && REG(DE) == reg->DE &&
+                               REG(HL) == reg->HL && REG(SP) == reg->SP && REG(IME) == reg->IME;
+
+    if (gb->cpu.idle_loop.address != REG(PC)) {
+        gb->cpu.idle_loop.address = REG(PC);
+        gb->cpu.idle_loop.is_pure = true;
+    } else if (is_same_loop && is_same_state && gb->cpu.idle_loop.is_pure) {
+        // Indirect reads depend on the registers, check the body again every time
+        gb->cpu.idle_loop.is_pure = is_idle_loop_body(gb, REG(PC), branch);
+    }
+
+    // A pending interrupt must be serviced right after this instruction
+    const bool is_interrupt_pending = gb->cpu.pending_interrupts != 0;
+
+    if (is_same_loop && is_same_state && gb->cpu.idle_loop.is_pure && !is_interrupt_pending) {
+        const uint64_t length = now - gb->cpu.idle_loop.cycles;
+        const uint32_t length_ticks = length << gb->cpu.is_double_speed;
+
+        // Land on the loop head before the deadline so the event hits the same instruction
+        uint64_t iterations = length > 0 && now < deadline ? (deadline - 1 - now) / length : 0;
+
+        if (iterations > 0) {
+            const uint32_t ticks = iterations * length_ticks;
+            tick_timer(gb, ticks);
+
+            gb->cpu.ticks += ticks;
+            gb->stats.idle_skipped_cycles += iterations * length;
+        }
+    }
+
+    gb->cpu.idle_loop.reg = gb->cpu.reg;
+    gb->cpu.idle_loop.cycles = gb->scheduler.cycles + (gb->cpu.ticks >> gb->cpu.is_double_speed);
+    gb->cpu.idle_loop.deadline = deadline;
+}
+
+// Only reads memory and writes to A and F, the other registers and memory stay untouched
+static bool is_idle_loop_body(GameBoy *gb, const uint16_t start, const uint16_t branch) {
+    uint16_t address = start;
+    uint16_t instr_start = start;
+
+    while (address <= branch) {
+        const uint8_t opcode = SREAD8(address);
+        uint16_t read_addr = 0;
+        instr_start = address;
+
+        if (opcode == 0xCB) {
+            const uint8_t cb_opcode = SREAD8(address + 1);
+            const uint8_t target = cb_opcode & 0x7;
+
+            // BIT n,r and rotates, shifts, SET and RES on A
+            if (!(cb_opcode >= 0x40 && cb_opcode <= 0x7F) && target != 0x7) {
+                return false;
+            }
+
+            if (target == 0x6 && is_timer_register(REG(HL))) {
+                return false;
+            }
+
+            address += 2;
+            continue;
+        }
+
+        if (opcode >= 0x78 && opcode <= 0xBF) {
+            // LD A,r and the 8 bit ALU with A
+            if ((opcode & 0x7) == 0x6 && is_timer_register(REG(HL))) {
+                return false;
+            }
+
+            address += 1;
+            continue;
+        }
+
+        switch (opcode) {
+        case 0x00: // NOP
+        case 0x07: // RLCA
+        case 0x0F: // RRCA
+        case 0x17: // RLA
+        case 0x1F: // RRA
+        case 0x27: // DAA
+        case 0x2F: // CPL
+        case 0x37: // SCF
+        case 0x3C: // INC A
+        case 0x3D: // DEC A
+        case 0x3F: // CCF
+            address += 1;
+            break;
+
+        case 0x0A: // LD A,(BC)
+            read_addr = REG(BC);
+            address += 1;
+            break;
+
+        case 0x1A: // LD A,(DE)
+            read_addr = REG(DE);
+            address += 1;
+            break;
+
+        case 0xF2: // LD A,(C)
+            read_addr = 0xFF00 + REG(C);
+            address += 1;
+            break;
+
+        case 0x18: // JR r8
+        case 0x20: // JR NZ,r8
+        case 0x28: // JR Z,r8
+        case 0x30: // JR NC,r8
+        case 0x38: // JR C,r8
+        case 0x3E: // LD A,d8
+        case 0xC6: // ADD A,d8
+        case 0xCE: // ADC A,d8
+        case 0xD6: // SUB d8
+        case 0xDE: // SBC A,d8
+        case 0xE6: // AND d8
+        case 0xEE: // XOR d8
+        case 0xF6: // OR d8
+        case 0xFE: // CP d8
+            address += 2;
+            break;
+
+        case 0xF0: // LDH A,(a8)
+            read_addr = 0xFF00 + SREAD8(address + 1);
+            address += 2;
+            break;
+
+        case 0xC2: // JP NZ,a16
+        case 0xC3: // JP a16
+        case 0xCA: // JP Z,a16
+        case 0xD2: // JP NC,a16
+        case 0xDA: // JP C,a16
+            address += 3;
+            break;
+
+        case 0xFA: // LD A,(a16)
+            read_addr = SREAD16(address + 1);
+            address += 3;
+            break;
+
+        default:
+            return false;
+        }
+
+        if (is_timer_register(read_addr)) {
+            return false;
+        }
     }
+
+    // The body must decode into instructions ending with the branch
+    return instr_start == branch;
 }
 
+// These change every clock, a loop polling them is never idle
+static bool is_timer_register(const uint16_t address) { return address == DIV || address == TIMA; }
+
 /*
     F Register Flags
 */
 
 void set_flag(GameBoy *gb, const uint8_t flag, const uint8_t value) {
     assert(value <= 1);
+    evaluate_flags(gb);
 
     if (value == 0) {
         REG(F) &= ~(1 << flag);
@@ -102,7 +555,10 @@ void set_flag(GameBoy *gb, const uint8_t flag, const uint8_t value) {
     }
 }
 
-uint8_t get_flag(GameBoy *gb, const uint8_t flag) { return GET_BIT(REG(F), flag); }
+uint8_t get_flag(GameBoy *gb, const uint8_t flag) {
+    evaluate_flags(gb);
+    return GET_BIT(REG(F), flag);
+}
 
 /*
     Stack
@@ -145,21 +601,32 @@ uint16_t stack_peek_short(GameBoy *gb) {
     Interrupts
 */
 
+// Any enabled and requested interrupt wakes the CPU, the one with the lowest bit is serviced if IME is set
 void check_interrupts(GameBoy *gb) {
-    const uint8_t enable = SREAD8(IE);
-    const uint8_t request = SREAD8(IF);
+    const uint8_t pending = gb->cpu.pending_interrupts;
 
-    for (uint8_t i = 0; i < 5; i++) {
-        if (GET_BIT(enable, i) && GET_BIT(request, i)) {
-            if (REG(IME)) {
-                service_interrupt(gb, i);
-            }
+    if (pending == 0) {
+        return;
+    }
+
+    gb->cpu.is_halted = false;
 
-            gb->cpu.is_halted = false;
+    if (REG(IME)) {
+        uint8_t number = 0;
+
+        while (!GET_BIT(pending, number)) {
+            number++;
         }
+
+        service_interrupt(gb, number);
     }
 }
 
+// Called whenever IE or IF is written
+void update_pending_interrupts(GameBoy *gb) {
+    gb->cpu.pending_interrupts = IREAD8(IE) & IREAD8(IF) & 0x1F;
+}
+
 static void service_interrupt(GameBoy *gb, const uint8_t number) {
     static const uint16_t interrupt[5] = {INT_VBLANK, INT_LCD_STAT, INT_TIMER, INT_SERIAL, INT_JOYPAD};
 
@@ -168,6 +635,9 @@ static void service_interrupt(GameBoy *gb, const uint8_t number) {
 
     WREG(IF, number, 0);
     REG(IME) = false;
+
+    // The handler runs in between loop iterations
+    gb->cpu.idle_loop.address = 0;
     REG(PC) = interrupt[number];
 }
 
@@ -175,54 +645,137 @@ static void service_interrupt(GameBoy *gb, const uint8_t number) {
     Timer
 */
 
-void set_div(GameBoy *gb, const uint16_t value) {
-    const uint8_t speed_index = SREAD8(TAC) & 0x3;
+// Bit of the internal divider selected by TAC
+static uint8_t timer_bit(GameBoy *gb) {
     static const uint8_t div_bit_pos[] = { 9, 3, 5, 7 };
+    return div_bit_pos[IREAD8(TAC) & 0x3];
+}
+
+// The selected bit falls once per period, TIMA counts these falling edges
+static uint32_t timer_period(GameBoy *gb) { return 2 << timer_bit(gb); }
+
+static uint8_t current_tima(GameBoy *gb) {
+    if (gb->cpu.timer.is_overflow_pending || !RREG(TAC, TAC_STOP)) {
+        return gb->cpu.timer.tima;
+    }
+
+    const uint32_t period = timer_period(gb);
+    const uint64_t div = gb->cpu.timer.clock - gb->cpu.timer.div_clock;
+    const uint64_t reference_div = gb->cpu.timer.tima_clock - gb->cpu.timer.div_clock;
+
+    return gb->cpu.timer.tima + (div / period - reference_div / period);
+}
 
-    const uint8_t old_mult_val = GET_BIT(gb->cpu.div, div_bit_pos[speed_index]);
-    const uint8_t new_mult_val = GET_BIT(value, div_bit_pos[speed_index]);
+// Moves the TIMA reference to the current clock
+static void sync_tima(GameBoy *gb) {
+    gb->cpu.timer.tima = current_tima(gb);
+    gb->cpu.timer.tima_clock = gb->cpu.timer.clock;
+}
 
-    const uint8_t tac_state = RREG(TAC, TAC_STOP);
-    const bool old_output = old_mult_val & tac_state;
-    const bool current_output = new_mult_val & tac_state;
+// Computes when TIMA overflows from its reference, the next update is the overflow or the TMA reload after it
+static void schedule_overflow(GameBoy *gb) {
+    if (gb->cpu.timer.is_overflow_pending) {
+        gb->cpu.timer.next_update = gb->cpu.timer.overflow_clock + CPU_STEP;
+        return;
+    }
 
-    // Falling edge of DIV bit, increment TIMA
-    if (old_output && !current_output) {
-        increment_tima(gb);
+    if (!RREG(TAC, TAC_STOP)) {
+        gb->cpu.timer.overflow_clock = UINT64_MAX;
+        gb->cpu.timer.next_update = UINT64_MAX;
+        return;
     }
 
-    // The divider register updates at one 256th of the clock speed (aka 256 clocks)
-    // Write the top half of the 16 bit internal divider register
-    SWRITE8(DIV, (value & 0xFF00) >> 8);
+    const uint32_t period = timer_period(gb);
+    const uint64_t div = gb->cpu.timer.tima_clock - gb->cpu.timer.div_clock;
+    const uint32_t increments = 256 - gb->cpu.timer.tima;
 
-    gb->cpu.div = value;
+    gb->cpu.timer.overflow_clock = gb->cpu.timer.tima_clock + (div / period + increments) * period - div;
+    gb->cpu.timer.next_update = gb->cpu.timer.overflow_clock;
 }
 
+// Called with TIMA synced to the current clock
 static void increment_tima(GameBoy *gb) {
-    const uint8_t tima = SREAD8(TIMA);
-
-    if (tima == 255) {
-        gb->cpu.div_overflow = true;
-        gb->cpu.div_overflow_ticks = 0;
-        SWRITE8(TIMA, 0);
+    if (gb->cpu.timer.tima == 255) {
+        // Outside of a counted edge, the reload comes a clock later
+        gb->cpu.timer.is_overflow_pending = true;
+        gb->cpu.timer.overflow_clock = gb->cpu.timer.clock + 1;
+        gb->cpu.timer.tima = 0;
     } else {
-        SWRITE8(TIMA, tima + 1);
+        gb->cpu.timer.tima++;
     }
 }
 
-void tick_timer(GameBoy *gb, const uint8_t ticks) {
-    for (uint8_t i = 0; i < ticks; ++i) {
-        set_div(gb, gb->cpu.div + 1);
+// TIMA reads 0 for a machine cycle after overflowing, then TMA is loaded and the interrupt requested
+void update_timer(GameBoy *gb) {
+    while (gb->cpu.timer.clock >= gb->cpu.timer.next_update) {
+        if (!gb->cpu.timer.is_overflow_pending) {
+            gb->cpu.timer.is_overflow_pending = true;
+            gb->cpu.timer.tima = 0;
+        } else {
+            gb->cpu.timer.is_overflow_pending = false;
+            gb->cpu.timer.tima = IREAD8(TMA);
+            gb->cpu.timer.tima_clock = gb->cpu.timer.overflow_clock + CPU_STEP;
+            WREG(IF, IEF_TIMER, 1);
+        }
 
-        if (gb->cpu.div_overflow) {
-            if (gb->cpu.div_overflow_ticks >= CPU_STEP) {
-                const uint8_t tma = SREAD8(TMA);
-                SWRITE8(TIMA, tma);
-                WREG(IF, IEF_TIMER, 1);
-                gb->cpu.div_overflow = false;
-            }
+        schedule_overflow(gb);
+    }
+}
+
+uint8_t timer_register_read(GameBoy *gb, const uint16_t address, const uint8_t data) {
+    switch (address) {
+    // The divider register is the top half of the 16 bit internal divider
+    case DIV:
+        return (gb->cpu.timer.clock - gb->cpu.timer.div_clock) >> 8;
 
-            gb->cpu.div_overflow_ticks++;
+    case TIMA:
+        return current_tima(gb);
+
+    default:
+        return data;
+    }
+}
+
+void timer_register_write(GameBoy *gb, const uint16_t address, const uint8_t value) {
+    switch (address) {
+    case DIV: {
+        const uint64_t div = gb->cpu.timer.clock - gb->cpu.timer.div_clock;
+        sync_tima(gb);
+
+        // Resetting DIV while the selected bit is set is a falling edge, increment TIMA
+        if (RREG(TAC, TAC_STOP) && GET_BIT(div, timer_bit(gb))) {
+            increment_tima(gb);
         }
+
+        gb->cpu.timer.div_clock = gb->cpu.timer.clock;
+        break;
     }
+
+    case TIMA:
+        // A reload that is already pending still overwrites the value
+        gb->cpu.timer.tima = value;
+        gb->cpu.timer.tima_clock = gb->cpu.timer.clock;
+        break;
+
+    // Count the edges of the old frequency up to now, then continue with the new one
+    case TAC:
+        sync_tima(gb);
+        IWRITE8(TAC, value);
+        break;
+
+    default:
+        return;
+    }
+
+    schedule_overflow(gb);
+}
+
+// Number of clocks until the timer requests an interrupt, UINT32_MAX if it is stopped
+static uint32_t timer_interrupt_ticks(GameBoy *gb) {
+    if (gb->cpu.timer.overflow_clock == UINT64_MAX) {
+        return UINT32_MAX;
+    }
+
+    const uint64_t ticks = gb->cpu.timer.overflow_clock + CPU_STEP - gb->cpu.timer.clock;
+    return ticks < UINT32_MAX ? ticks : UINT32_MAX;
 }
@@ -26,6 +26,7 @@ Debugger::Debugger(const char *rom_path) {
     _is_paused = true;
     _window = nullptr;
     _gl_context = nullptr;
+    _audio_device = 0;
 
     _next_stop_fall_thru = std::nullopt;
     _next_stop_jump = std::nullopt;
@@ -46,8 +47,12 @@ Debugger::Debugger(const char *rom_path) {
     init_gl();
     init_imgui();
 
+    if (Emulator::open_audio(_gb.get(), &_audio_device) == 0) {
+        std::cerr << "ERROR: Cannot open audio device: " << SDL_GetError() << std::endl;
+    }
+
     std::ostringstream title;
-    title << WINDOW_TITLE << " - " << _gb->cart.title << " (DEBUGGER)";
+    title << WINDOW_TITLE << " - " << _gb->cart.image->title << " (DEBUGGER)";
     SDL_SetWindowTitle(_window, title.str().c_str());
 
     _windows.emplace(WindowId::Breakpoints, std::make_shared<Windows::Breakpoints>(*this));
@@ -62,7 +67,8 @@ Debugger::Debugger(const char *rom_path) {
     _windows.emplace(WindowId::Stack, std::make_shared<Windows::Stack>(*this));
 
     auto serial_window = std::make_shared<Windows::Serial>(*this);
-    _gb->mmu.serial_write_handler = serial_window->serial_write_handler;
+    _gb->mmu.serial_write_handler = Windows::Serial::serial_write_handler;
+    _gb->mmu.serial_user_data = serial_window.get();
     _windows.emplace(WindowId::Serial, serial_window);
 
     load_symbols(rom_path);
@@ -101,7 +107,7 @@ bool Debugger::is_paused() const { return _is_paused; }
 
 void Debugger::set_paused(const bool value) {
     _is_paused = value;
-    SDL_PauseAudioDevice(_gb->apu.device_id, value);
+    SDL_PauseAudioDevice(_audio_device, value);
 }
 
 void Debugger::set_next_stop(const std::optional<uint16_t> fall_thru_addr, const std::optional<uint16_t> jump_addr) {
@@ -182,31 +188,16 @@ void Debugger::run() {
     SDL_Event event;
     _gb->is_running = true;
 
-    static auto window_disassembly =
+    const auto window_disassembly =
         std::dynamic_pointer_cast<Windows::Disassembly>(_windows.at(WindowId::Disassembly));
-    static auto *gb = _gb.get();
+    auto *gb = _gb.get();
 
     while (_gb->is_running) {
-        static const uint32_t max_ticks = CLOCK_SPEED / FRAMERATE;
-
-        if (!SDL_GetQueuedAudioSize(_gb->apu.device_id)) {
-            uint32_t frame_ticks = 0;
-
-            while (!_is_paused && frame_ticks < max_ticks) {
-                Emulator::update_cpu(_gb.get());
-
-                if (_gb->cpu.is_double_speed) {
-                    Emulator::check_interrupts(_gb.get());
-                    Emulator::update_cpu(_gb.get());
-                }
-
-                Emulator::check_interrupts(_gb.get());
-                Emulator::update_ppu(_gb.get());
-                Emulator::update_apu(_gb.get());
-                Emulator::update_dma(_gb.get());
-                Emulator::update_hdma(_gb.get());
+        if (!SDL_GetQueuedAudioSize(_audio_device)) {
+            _gb->scheduler.is_frame_done = false;
 
-                frame_ticks += _gb->cpu.ticks;
+            while (!_is_paused && !_gb->scheduler.is_frame_done) {
+                Emulator::run_instruction(_gb.get());
 
                 if (is_breakpoint(_gb->cpu.reg.PC)) {
                     window_disassembly->scroll_to_address(_gb->cpu.reg.PC);
@@ -17,13 +17,12 @@ void Breakpoints::render() {
 
     ImGui::BeginChild("##scroll");
     const ImU32 step = 1, step_fast = 50;
-    static uint32_t addr = 0;
-    ImGui::InputScalar("ADDR", ImGuiDataType_U32, &addr, &step, &step_fast, "%04X",
+    ImGui::InputScalar("ADDR", ImGuiDataType_U32, &_addr, &step, &step_fast, "%04X",
                        ImGuiInputTextFlags_CharsHexadecimal);
     ImGui::SameLine();
 
     if (ImGui::Button("Add")) {
-        debugger().add_breakpoint(addr);
+        debugger().add_breakpoint(_addr);
     }
 
     ImGui::Text("Presets");
@@ -76,25 +75,25 @@ void Breakpoints::render() {
             const auto instr = Emulator::find_instr(gb, bp);
             const auto opcode = SREAD8(bp);
 
-            if (instr.length > 1 && opcode != 0xCB) {
+            if (instr->length > 1 && opcode != 0xCB) {
                 uint16_t operand = 0;
 
-                if (instr.length == 2) {
+                if (instr->length == 2) {
                     operand = SREAD8(bp + 1);
 
                     // If the operand is signed, get the two's complement
-                    if (instr.signed_operand) {
+                    if (instr->signed_operand) {
                         operand = (~(operand - 1)) & 0x00FF;
                     }
-                } else if (instr.length == 3) {
+                } else if (instr->length == 3) {
                     operand = SREAD16(bp + 1);
                 }
 
-                ImGui::Text(instr.disassembly, operand);
+                ImGui::Text(instr->disassembly, operand);
             }
             // If there is no operand (or CB opcode which have no operand)
             else {
-                ImGui::Text("%s", instr.disassembly);
+                ImGui::Text("%s", instr->disassembly);
             }
 
             ImGui::PopID();
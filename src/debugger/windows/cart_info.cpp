@@ -15,23 +15,23 @@ void CartInfo::render() {
 
     ImGui::TextColored(Colours::address, "Title:");
     ImGui::SameLine();
-    ImGui::Text("%s", debugger().gb()->cart.title);
+    ImGui::Text("%s", debugger().gb()->cart.image->title);
 
     ImGui::TextColored(Colours::address, "Colour:");
     ImGui::SameLine();
-    ImGui::Text("%s", debugger().gb()->cart.is_colour ? "yes" : "no");
+    ImGui::Text("%s", debugger().gb()->cart.image->is_colour ? "yes" : "no");
 
     ImGui::TextColored(Colours::address, "Cartridge Type:");
     ImGui::SameLine();
-    ImGui::Text("%02X", debugger().gb()->cart.type);
+    ImGui::Text("%02X", debugger().gb()->cart.image->type);
 
     ImGui::TextColored(Colours::address, "ROM Size:");
     ImGui::SameLine();
-    ImGui::Text("%d x %d KB", debugger().gb()->cart.rom_size, ROM_BANK_SIZE);
+    ImGui::Text("%d x %d KB", debugger().gb()->cart.image->rom_size, ROM_BANK_SIZE);
 
     ImGui::TextColored(Colours::address, "RAM Size:");
     ImGui::SameLine();
-    ImGui::Text("%d x %d KB", debugger().gb()->cart.ram_size, EXTRAM_BANK_SIZE);
+    ImGui::Text("%d x %d KB", debugger().gb()->cart.image->ram_size, EXTRAM_BANK_SIZE);
 
     ImGui::End();
 }
@@ -47,11 +47,11 @@ void Controls::step_into() {
     if (is_jump_call(opcode) || is_subroutine_call(opcode)) {
         debugger().set_next_stop(std::nullopt, SREAD16(REG(PC) + 1));
     } else if (is_jump_signed(opcode)) {
-        const auto fall_thru_addr = REG(PC) + Emulator::find_instr(gb, REG(PC)).length;
+        const auto fall_thru_addr = REG(PC) + Emulator::find_instr(gb, REG(PC))->length;
 
         // The PC hasn't been incremented yet, add the length of the current instruction
         const auto operand = static_cast<int8_t>(SREAD8(REG(PC) + 1));
-        const auto jump_addr = REG(PC) + operand + Emulator::find_instr(gb, REG(PC)).length;
+        const auto jump_addr = REG(PC) + operand + Emulator::find_instr(gb, REG(PC))->length;
 
         debugger().set_next_stop(fall_thru_addr, jump_addr);
     } else if (is_return(opcode)) {
@@ -79,7 +79,7 @@ void Controls::step_over() {
 void Controls::run_to_next() const {
     INIT_GB_CTX();
     const auto instr = Emulator::find_instr(gb, REG(PC));
-    debugger().set_next_stop(REG(PC) + instr.length, std::nullopt);
+    debugger().set_next_stop(REG(PC) + instr->length, std::nullopt);
 }
 
 constexpr bool Controls::is_subroutine_call(const uint8_t opcode) {
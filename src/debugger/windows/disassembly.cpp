@@ -9,6 +9,7 @@ using namespace Windows;
 
 Disassembly::Disassembly(Debugger &debugger) : Window(debugger) {
     _address_to_scroll_to = PROGRAM_START;
+    _selected_label_addr = PROGRAM_START;
 
     _labels.emplace(PROGRAM_START, "Program Start");
     _labels.emplace(CART_HEADER_START + 4, "Cartridge Header");
@@ -33,14 +34,13 @@ void Disassembly::render() {
 
     ImGui::SameLine();
 
-    static uint16_t selected_label_addr = _labels.begin()->first;
-    if (ImGui::BeginCombo("Label", _labels.at(selected_label_addr).c_str())) {
+    if (ImGui::BeginCombo("Label", _labels.at(_selected_label_addr).c_str())) {
 
         for (const auto &[addr, name] : _labels) {
             ImGui::PushID(reinterpret_cast<void *>(addr));
 
-            if (ImGui::Selectable(name.c_str(), selected_label_addr == addr)) {
-                selected_label_addr = addr;
+            if (ImGui::Selectable(name.c_str(), _selected_label_addr == addr)) {
+                _selected_label_addr = addr;
             }
 
             ImGui::PopID();
@@ -52,7 +52,7 @@ void Disassembly::render() {
     ImGui::SameLine();
 
     if (ImGui::Button("Goto")) {
-        _address_to_scroll_to = selected_label_addr;
+        _address_to_scroll_to = _selected_label_addr;
     }
 
     ImGui::BeginChild("##scroll");
@@ -81,7 +81,7 @@ void Disassembly::render() {
             if (is_executable(addr)) {
                 const auto instr = Emulator::find_instr(gb, addr);
                 draw_instr_line(addr, instr);
-                addr += instr.length;
+                addr += instr->length;
             } else {
                 draw_data_line(addr);
                 addr++;
@@ -98,7 +98,7 @@ void Disassembly::render() {
 
 constexpr const char *Disassembly::title() const { return "Disassembly"; }
 
-void Disassembly::draw_instr_line(uint16_t addr, const Emulator::Instruction &instr) {
+void Disassembly::draw_instr_line(uint16_t addr, const Emulator::Instruction *instr) {
     INIT_GB_CTX();
 
     const auto line_coords = ImGui::GetCursorScreenPos();
@@ -122,26 +122,26 @@ void Disassembly::draw_instr_line(uint16_t addr, const Emulator::Instruction &in
     ImGui::TextColored(Colours::instruction, "%02X", opcode);
     ImGui::SameLine();
 
-    if (instr.length > 1 && opcode != 0xCB) {
+    if (instr->length > 1 && opcode != 0xCB) {
         uint16_t operand = 0;
         uint16_t label_addr = 0;
 
-        if (instr.length == 2) {
+        if (instr->length == 2) {
             operand = SREAD8(addr + 1);
             ImGui::TextColored(Colours::data, "%02X", operand);
 
-            if (instr.signed_operand) {
+            if (instr->signed_operand) {
                 const auto jump_addr = addr + static_cast<int8_t>(operand);
-                label_addr = jump_addr + Emulator::find_instr(gb, jump_addr).length;
+                label_addr = jump_addr + Emulator::find_instr(gb, jump_addr)->length;
             }
-        } else if (instr.length == 3) {
+        } else if (instr->length == 3) {
             operand = SREAD16(addr + 1);
             ImGui::TextColored(Colours::data, "%02X %02X", operand & 0xFF, (operand & 0xFF00) >> 8);
             label_addr = operand;
         }
 
         ImGui::SameLine(300);
-        ImGui::TextColored(Colours::disassembly, instr.disassembly, operand);
+        ImGui::TextColored(Colours::disassembly, instr->disassembly, operand);
 
         if (label_addr > 0 && _labels.find(label_addr) != _labels.end()) {
             ImGui::SameLine();
@@ -156,7 +156,7 @@ void Disassembly::draw_instr_line(uint16_t addr, const Emulator::Instruction &in
         }
 
         ImGui::SameLine(300);
-        ImGui::TextColored(Colours::disassembly, instr.disassembly, addr);
+        ImGui::TextColored(Colours::disassembly, instr->disassembly, addr);
     }
 }
 
@@ -247,7 +247,7 @@ uint16_t Disassembly::address_of_nth_line(const uint16_t start_addr, const size_
     for (uint32_t addr = start_addr; addr <= 0xFFFF; count++) {
 
         if (is_executable(addr)) {
-            addr += Emulator::find_instr(debugger().gb().get(), addr).length;
+            addr += Emulator::find_instr(debugger().gb().get(), addr)->length;
         } else {
             addr++;
         }
@@ -265,7 +265,7 @@ size_t Disassembly::line_count(const uint16_t from_addr, const uint16_t to_addr)
 
     for (uint32_t addr = from_addr; addr <= to_addr;) {
         if (is_executable(addr)) {
-            addr += Emulator::find_instr(debugger().gb().get(), addr).length;
+            addr += Emulator::find_instr(debugger().gb().get(), addr)->length;
         } else {
             addr++;
         }
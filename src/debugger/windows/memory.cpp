@@ -36,6 +36,8 @@ void Memory::render() {
             debugger().gb()->mmu.extram, debugger().gb()->mmu.wram00, debugger().gb()->mmu.wramNN,
             debugger().gb()->mmu.oam,    debugger().gb()->mmu.io,     debugger().gb()->mmu.hram};
 
+        // The rom is mapped read only
+        _editor.ReadOnly = _offsets[_selected_idx] <= ROMNN_END;
         _editor.DrawContents(_regions[_selected_idx], _sizes[_selected_idx], _offsets[_selected_idx]);
     }
 
@@ -14,6 +14,9 @@ void Registers::render() {
 
     INIT_GB_CTX();
 
+    // F is written to directly below
+    Emulator::evaluate_flags(gb);
+
     ImGui::Columns(2, nullptr, true);
 
     ImGui::Text("CPU");
@@ -3,8 +3,6 @@
 
 using namespace Windows;
 
-std::stringstream Serial::_buffer;
-
 Serial::Serial(Debugger &debugger) : Window(debugger) {}
 
 void Serial::render() {
@@ -26,4 +24,7 @@ void Serial::render() {
 
 constexpr const char *Serial::title() const { return "Serial Output"; }
 
-void Serial::serial_write_handler(const uint8_t data) { _buffer << static_cast<char>(data); }
+// The user data is the window of the emulator instance writing
+void Serial::serial_write_handler(void *user_data, const uint8_t data) {
+    static_cast<Serial *>(user_data)->_buffer << static_cast<char>(data);
+}
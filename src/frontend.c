@@ -0,0 +1,70 @@
+#include "frontend.h"
+#include "apu.h"
+#include "input.h"
+
+static void queue_audio(void *, const float *, size_t);
+
+void set_key(GameBoy *gb, const SDL_Scancode code, const bool is_pressed) {
+    switch (code) {
+    case SDL_SCANCODE_RETURN:
+        set_button(gb, ButtonStart, is_pressed);
+        break;
+
+    case SDL_SCANCODE_BACKSPACE:
+        set_button(gb, ButtonSelect, is_pressed);
+        break;
+
+    case SDL_SCANCODE_A:
+        set_button(gb, ButtonA, is_pressed);
+        break;
+
+    case SDL_SCANCODE_S:
+        set_button(gb, ButtonB, is_pressed);
+        break;
+
+    case SDL_SCANCODE_UP:
+        set_button(gb, ButtonUp, is_pressed);
+        break;
+
+    case SDL_SCANCODE_RIGHT:
+        set_button(gb, ButtonRight, is_pressed);
+        break;
+
+    case SDL_SCANCODE_DOWN:
+        set_button(gb, ButtonDown, is_pressed);
+        break;
+
+    case SDL_SCANCODE_LEFT:
+        set_button(gb, ButtonLeft, is_pressed);
+        break;
+
+    default:
+        break;
+    }
+}
+
+// Opens a paused device and queues the samples of the APU to it
+// The device id is stored where the handler reads it, 0 when no device could be opened
+SDL_AudioDeviceID open_audio(GameBoy *gb, SDL_AudioDeviceID *device) {
+    SDL_AudioSpec desired_spec;
+    SDL_zero(desired_spec);
+
+    desired_spec.freq = SAMPLE_RATE;
+    desired_spec.format = AUDIO_F32SYS;
+    desired_spec.channels = AUDIO_CHANNELS;
+    desired_spec.samples = AUDIO_SAMPLES;
+
+    SDL_AudioSpec audio_spec;
+    *device = SDL_OpenAudioDevice(NULL, 0, &desired_spec, &audio_spec, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
+
+    if (*device != 0) {
+        gb->apu.audio_handler = queue_audio;
+        gb->apu.audio_user_data = device;
+    }
+
+    return *device;
+}
+
+static void queue_audio(void *user_data, const float *samples, const size_t count) {
+    SDL_QueueAudio(*(SDL_AudioDeviceID *) user_data, samples, count * sizeof(float));
+}
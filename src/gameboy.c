@@ -1,44 +1,86 @@
 #include "gameboy.h"
 #include "apu.h"
+#include "arena.h"
+#include "block.h"
 #include "cpu.h"
 #include "input.h"
 #include "mmu.h"
 #include "ppu.h"
+#include "scheduler.h"
 
 static void reset_hw_registers(GameBoy *);
 
 void init(GameBoy *gb) {
+    init_arena(gb);
     init_mmu(gb);
     init_ppu(gb);
     init_apu(gb);
+    init_blocks(gb);
 
     reset(gb);
 }
 
+// Frees what init allocated, the cart has to be detached first
+void destroy(GameBoy *gb) {
+    free_blocks(gb);
+    free_apu(gb);
+    free_arena(gb);
+}
+
 void reset(GameBoy *gb) {
+    reset_scheduler(gb);
     reset_cpu(gb);
+    flush_blocks(gb);
     reset_mmu(gb);
     reset_ppu(gb);
     reset_input(gb);
     reset_apu(gb);
     reset_hw_registers(gb);
+
+    gb->stats.instructions = 0;
+    gb->stats.block_instructions = 0;
+    gb->stats.halt_skipped_cycles = 0;
+    gb->stats.idle_skipped_cycles = 0;
+}
+
+// Runs until the end of the current frame
+// The CPU executes uninterrupted until the next event is due
+void run_frame(GameBoy *gb) {
+    gb->scheduler.is_frame_done = false;
+
+    while (!gb->scheduler.is_frame_done) {
+        run_cpu(gb, next_event_time(gb));
+        run_events(gb);
+        check_interrupts(gb);
+    }
+}
+
+// Executes a single instruction and fires any event that became due
+void run_instruction(GameBoy *gb) {
+    update_cpu(gb);
+    check_interrupts(gb);
+
+    if (gb->scheduler.cycles >= next_event_time(gb)) {
+        run_events(gb);
+        check_interrupts(gb);
+    }
 }
 
 static void reset_hw_registers(GameBoy *gb) {
-    SWRITE8(JOYP, 0x1F);
-    SWRITE8(IF, 0xE0);
-    SWRITE8(TIMA, 0x00);
-    SWRITE8(TMA, 0x00);
-    SWRITE8(TAC, 0x00);
-    SWRITE8(LCDC, 0x91);
-    SWRITE8(SCY, 0x00);
-    SWRITE8(SCX, 0x00);
-    SWRITE8(LYC, 0x00);
-    SWRITE8(LY, 0x00);
-    SWRITE8(BGP, 0xFC);
-    SWRITE8(OBP0, 0xFF);
-    SWRITE8(OBP1, 0xFF);
-    SWRITE8(WY, 0x00);
-    SWRITE8(WX, 0x00);
-    SWRITE8(IE, 0x00);
+    IWRITE8(JOYP, 0x1F);
+    IWRITE8(IF, 0xE0);
+    IWRITE8(TIMA, 0x00);
+    IWRITE8(TMA, 0x00);
+    IWRITE8(TAC, 0x00);
+    IWRITE8(LCDC, 0x91);
+    IWRITE8(SCY, 0x00);
+    IWRITE8(SCX, 0x00);
+    IWRITE8(LYC, 0x00);
+    IWRITE8(LY, 0x00);
+    IWRITE8(BGP, 0xFC);
+    IWRITE8(OBP0, 0xFF);
+    IWRITE8(OBP1, 0xFF);
+    IWRITE8(WY, 0x00);
+    IWRITE8(WX, 0x00);
+    IWRITE8(IE, 0x00);
 }
@@ -12,47 +12,44 @@ void reset_input(GameBoy *gb) {
     gb->input.b = false;
 }
 
-void set_key(GameBoy *gb, const SDL_Scancode code, const bool is_pressed) {
-    switch (code) {
-    case SDL_SCANCODE_RETURN:
-        gb->input.start = is_pressed;
-        break;
-
-    case SDL_SCANCODE_BACKSPACE:
-        gb->input.select = is_pressed;
-        break;
-
-    case SDL_SCANCODE_A:
+void set_button(GameBoy *gb, const Button button, const bool is_pressed) {
+    switch (button) {
+    case ButtonA:
         gb->input.a = is_pressed;
         break;
 
-    case SDL_SCANCODE_S:
+    case ButtonB:
         gb->input.b = is_pressed;
         break;
 
-    case SDL_SCANCODE_UP:
-        gb->input.up = is_pressed;
+    case ButtonSelect:
+        gb->input.select = is_pressed;
         break;
 
-    case SDL_SCANCODE_RIGHT:
-        gb->input.right = is_pressed;
+    case ButtonStart:
+        gb->input.start = is_pressed;
         break;
 
-    case SDL_SCANCODE_DOWN:
-        gb->input.down = is_pressed;
+    case ButtonRight:
+        gb->input.right = is_pressed;
         break;
 
-    case SDL_SCANCODE_LEFT:
+    case ButtonLeft:
         gb->input.left = is_pressed;
         break;
 
-    default:
+    case ButtonUp:
+        gb->input.up = is_pressed;
+        break;
+
+    case ButtonDown:
+        gb->input.down = is_pressed;
         break;
     }
 }
 
-uint8_t joypad_state(GameBoy *gb) {
-    uint8_t joypad = SREAD8(JOYP);
+// Sets the key bits of the selected group in the stored register
+uint8_t joypad_state(GameBoy *gb, uint8_t joypad) {
 
     if ((joypad & JOYP_DIR) == 0) {
         SET_KEY(KEY_UP_SELECT, gb->input.up, joypad);
@@ -66,6 +63,6 @@ uint8_t joypad_state(GameBoy *gb) {
         SET_KEY(KEY_LEFT_B, gb->input.b, joypad);
     }
 
-    SWRITE8(JOYP, joypad);
+    IWRITE8(JOYP, joypad);
     return joypad;
 }
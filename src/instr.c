@@ -2,6 +2,31 @@
 #include "alu.h"
 #include "cpu.h"
 #include "mmu.h"
+#include <stddef.h>
+
+#define CB_OPERAND_HL 0x6
+
+static void jump_relative(GameBoy *, int8_t);
+static void jump(GameBoy *, uint16_t);
+static void call(GameBoy *, uint16_t);
+static uint8_t *cb_register(GameBoy *, uint8_t);
+static uint8_t rotate_shift(GameBoy *, uint8_t, uint8_t);
+
+static void jump_relative(GameBoy *gb, const int8_t offset) {
+    REG(PC) += offset;
+    TICK(1);
+}
+
+static void jump(GameBoy *gb, const uint16_t address) {
+    REG(PC) = address;
+    TICK(1);
+}
+
+static void call(GameBoy *gb, const uint16_t address) {
+    PUSH16(REG(PC));
+    REG(PC) = address;
+    TICK(3);
+}
 
 // 0x00: NOP (- - - -)
 void op_nop(GameBoy *gb) {
@@ -9,7 +34,7 @@ void op_nop(GameBoy *gb) {
 }
 
 // 0x01: LD BC, d16 (- - - -)
-void op_ld_bc_d16(GameBoy *gb, const uint16_t operand) { REG(BC) = operand; }
+void op_ld_bc_d16(GameBoy *gb) { REG(BC) = FETCH16(); }
 
 // 0x02: LD (BC), A (- - - -)
 void op_ld_bcp_a(GameBoy *gb) {
@@ -30,13 +55,14 @@ void op_inc_b(GameBoy *gb) { REG(B) = inc(gb, REG(B)); }
 void op_dec_b(GameBoy *gb) { REG(B) = dec(gb, REG(B)); }
 
 // 0x06: LD B, d8 (- - - -)
-void op_ld_b_d8(GameBoy *gb, const uint8_t operand) { REG(B) = operand; }
+void op_ld_b_d8(GameBoy *gb) { REG(B) = FETCH8(); }
 
 // 0x07: RLCA (0 0 0 C)
 void op_rlca(GameBoy *gb) { REG(A) = rotate_left_carry(gb, REG(A), false); }
 
 // 0x08: LD (a16), SP (- - - -)
-void op_ld_a16p_sp(GameBoy *gb, const uint16_t operand) {
+void op_ld_a16p_sp(GameBoy *gb) {
+    const uint16_t operand = FETCH16();
     WRITE16(operand, REG(SP));
     TICK(2);
 }
@@ -66,7 +92,7 @@ void op_inc_c(GameBoy *gb) { REG(C) = inc(gb, REG(C)); }
 void op_dec_c(GameBoy *gb) { REG(C) = dec(gb, REG(C)); }
 
 // 0x0E: LD C, d8 (- - - -)
-void op_ld_c_d8(GameBoy *gb, const uint8_t operand) { REG(C) = operand; }
+void op_ld_c_d8(GameBoy *gb) { REG(C) = FETCH8(); }
 
 // 0x0F: RRCA (0 0 0 C)
 void op_rrca(GameBoy *gb) { REG(A) = rotate_right_carry(gb, REG(A), false); }
@@ -80,7 +106,7 @@ void op_stop(GameBoy *gb) {
 }
 
 // 0x11: LD DE, d16 (- - - -)
-void op_ld_de_d16(GameBoy *gb, const uint16_t operand) { REG(DE) = operand; }
+void op_ld_de_d16(GameBoy *gb) { REG(DE) = FETCH16(); }
 
 // 0x12: LD (DE), A (- - - -)
 void op_ld_dep_a(GameBoy *gb) {
@@ -101,16 +127,13 @@ void op_inc_d(GameBoy *gb) { REG(D) = inc(gb, REG(D)); }
 void op_dec_d(GameBoy *gb) { REG(D) = dec(gb, REG(D)); }
 
 // 0x16: LD D, d8 (- - - -)
-void op_ld_d_d8(GameBoy *gb, const uint8_t operand) { REG(D) = operand; }
+void op_ld_d_d8(GameBoy *gb) { REG(D) = FETCH8(); }
 
 // 0x17: RLA (0 0 0 C)
 void op_rla(GameBoy *gb) { REG(A) = rotate_left(gb, REG(A), false); }
 
 // 0x18: JR r8 (- - - -)
-void op_jr_r8(GameBoy *gb, const int8_t operand) {
-    REG(PC) += operand;
-    TICK(1);
-}
+void op_jr_r8(GameBoy *gb) { jump_relative(gb, (int8_t) FETCH8()); }
 
 // 0x19: ADD HL, DE (- 0 H C)
 void op_add_hl_de(GameBoy *gb) {
@@ -137,7 +160,7 @@ void op_inc_e(GameBoy *gb) { REG(E) = inc(gb, REG(E)); }
 void op_dec_e(GameBoy *gb) { REG(E) = dec(gb, REG(E)); }
 
 // 0x1E: LD E, d8 (- - - -)
-void op_ld_e_d8(GameBoy *gb, const uint8_t operand) { REG(E) = operand; }
+void op_ld_e_d8(GameBoy *gb) { REG(E) = FETCH8(); }
 
 // 0x1F: RRA (0 0 0 C)
 void op_rra(GameBoy *gb) {
@@ -146,14 +169,16 @@ void op_rra(GameBoy *gb) {
 }
 
 // 0x20: JR NZ, r8 (- - - -)
-void op_jr_nz_r8(GameBoy *gb, const int8_t operand) {
+void op_jr_nz_r8(GameBoy *gb) {
+    const int8_t operand = FETCH8();
+
     if (!FGET(FLAG_ZERO)) {
-        op_jr_r8(gb, operand);
+        jump_relative(gb, operand);
     }
 }
 
 // 0x21: LD HL, d16 (- - - -)
-void op_ld_hl_d16(GameBoy *gb, const uint16_t operand) { REG(HL) = operand; }
+void op_ld_hl_d16(GameBoy *gb) { REG(HL) = FETCH16(); }
 
 // 0x22: LD (HL+), A (- - - -)
 void op_ld_hlpp_a(GameBoy *gb) {
@@ -175,15 +200,17 @@ void op_inc_h(GameBoy *gb) { REG(H) = inc(gb, REG(H)); }
 void op_dec_h(GameBoy *gb) { REG(H) = dec(gb, REG(H)); }
 
 // 0x26: LD H, d8 (- - - -)
-void op_ld_h_d8(GameBoy *gb, const uint8_t operand) { REG(H) = operand; }
+void op_ld_h_d8(GameBoy *gb) { REG(H) = FETCH8(); }
 
 // 0x27: DAA (Z - 0 C)
 void op_daa(GameBoy *gb) { REG(A) = daa(gb, REG(A)); }
 
 // 0x28: JR Z, r8 (- - - -)
-void op_jr_z_r8(GameBoy *gb, const int8_t operand) {
+void op_jr_z_r8(GameBoy *gb) {
+    const int8_t operand = FETCH8();
+
     if (FGET(FLAG_ZERO)) {
-        op_jr_r8(gb, operand);
+        jump_relative(gb, operand);
     }
 }
 
@@ -213,7 +240,7 @@ void op_inc_l(GameBoy *gb) { REG(L) = inc(gb, REG(L)); }
 void op_dec_l(GameBoy *gb) { REG(L) = dec(gb, REG(L)); }
 
 // 0x2E: LD L, d8 (- - - -)
-void op_ld_l_d8(GameBoy *gb, const uint8_t operand) { REG(L) = operand; }
+void op_ld_l_d8(GameBoy *gb) { REG(L) = FETCH8(); }
 
 // 0x2F: CPL (- 1 1 -)
 void op_cpl(GameBoy *gb) {
@@ -223,14 +250,16 @@ void op_cpl(GameBoy *gb) {
 }
 
 // 0x30: JR NC, r8 (- - - -)
-void op_jr_nc_r8(GameBoy *gb, const int8_t operand) {
+void op_jr_nc_r8(GameBoy *gb) {
+    const int8_t operand = FETCH8();
+
     if (!FGET(FLAG_CARRY)) {
-        op_jr_r8(gb, operand);
+        jump_relative(gb, operand);
     }
 }
 
 // 0x31: LD SP, d16 (- - - -)
-void op_ld_sp_d16(GameBoy *gb, const uint16_t operand) { REG(SP) = operand; }
+void op_ld_sp_d16(GameBoy *gb) { REG(SP) = FETCH16(); }
 
 // 0x32: LD (HL-), A (- - - -)
 void op_ld_hlmp_a(GameBoy *gb) {
@@ -262,7 +291,8 @@ void op_dec_hlp(GameBoy *gb) {
 }
 
 // 0x36: LD (HL), d8 (- - - -)
-void op_ld_hlp_d8(GameBoy *gb, const uint8_t operand) {
+void op_ld_hlp_d8(GameBoy *gb) {
+    const uint8_t operand = FETCH8();
     WRITE8(REG(HL), operand);
     TICK(1);
 }
@@ -275,9 +305,11 @@ void op_scf(GameBoy *gb) {
 }
 
 // 0x38: JR C, r8 (- - - -)
-void op_jr_c_r8(GameBoy *gb, const int8_t operand) {
+void op_jr_c_r8(GameBoy *gb) {
+    const int8_t operand = FETCH8();
+
     if (FGET(FLAG_CARRY)) {
-        op_jr_r8(gb, operand);
+        jump_relative(gb, operand);
     }
 }
 
@@ -307,7 +339,7 @@ void op_inc_a(GameBoy *gb) { REG(A) = inc(gb, REG(A)); }
 void op_dec_a(GameBoy *gb) { REG(A) = dec(gb, REG(A)); }
 
 // 0x3E: LD A, d8 (- - - -)
-void op_ld_a_d8(GameBoy *gb, const uint8_t operand) { REG(A) = operand; }
+void op_ld_a_d8(GameBoy *gb) { REG(A) = FETCH8(); }
 
 // 0x3F: CCF (- 0 0 C)
 void op_ccf(GameBoy *gb) {
@@ -782,22 +814,23 @@ void op_pop_bc(GameBoy *gb) {
 }
 
 // 0xC2: JP NZ, a16 (- - - -)
-void op_jp_nz_a16(GameBoy *gb, const uint16_t operand) {
+void op_jp_nz_a16(GameBoy *gb) {
+    const uint16_t operand = FETCH16();
+
     if (!FGET(FLAG_ZERO)) {
-        op_jp_a16(gb, operand);
+        jump(gb, operand);
     }
 }
 
 // 0xC3: JP a16 (- - - -)
-void op_jp_a16(GameBoy *gb, const uint16_t operand) {
-    REG(PC) = operand;
-    TICK(1);
-}
+void op_jp_a16(GameBoy *gb) { jump(gb, FETCH16()); }
 
 // 0xC4: CALL NZ, a16 (- - - -)
-void op_call_nz_a16(GameBoy *gb, const uint16_t operand) {
+void op_call_nz_a16(GameBoy *gb) {
+    const uint16_t operand = FETCH16();
+
     if (!FGET(FLAG_ZERO)) {
-        op_call_a16(gb, operand);
+        call(gb, operand);
     }
 }
 
@@ -808,7 +841,7 @@ void op_push_bc(GameBoy *gb) {
 }
 
 // 0xC6: ADD A, d8 (Z 0 H C)
-void op_add_a_d8(GameBoy *gb, const uint8_t operand) { REG(A) = add_byte(gb, REG(A), operand); }
+void op_add_a_d8(GameBoy *gb) { REG(A) = add_byte(gb, REG(A), FETCH8()); }
 
 // 0xC7: RST 00H (- - - -)
 void op_rst_00h(GameBoy *gb) {
@@ -833,33 +866,31 @@ void op_ret(GameBoy *gb) {
 }
 
 // 0xCA: JP Z, a16 (- - - -)
-void op_jp_z_a16(GameBoy *gb, const uint16_t operand) {
+void op_jp_z_a16(GameBoy *gb) {
+    const uint16_t operand = FETCH16();
+
     if (FGET(FLAG_ZERO)) {
-        op_jp_a16(gb, operand);
+        jump(gb, operand);
     }
 }
 
 // 0xCB: PREFIX CB (- - - -)
-void op_prefix_cb(GameBoy *gb) {
-    // Do nothing, placeholder function
-}
+void op_prefix_cb(GameBoy *gb) { execute_cb(gb, FETCH8()); }
 
 // 0xCC: CALL Z, a16 (- - - -)
-void op_call_z_a16(GameBoy *gb, const uint16_t operand) {
+void op_call_z_a16(GameBoy *gb) {
+    const uint16_t operand = FETCH16();
+
     if (FGET(FLAG_ZERO)) {
-        op_call_a16(gb, operand);
+        call(gb, operand);
     }
 }
 
 // 0xCD: CALL a16 (- - - -)
-void op_call_a16(GameBoy *gb, const uint16_t operand) {
-    PUSH16(REG(PC));
-    REG(PC) = operand;
-    TICK(3);
-}
+void op_call_a16(GameBoy *gb) { call(gb, FETCH16()); }
 
 // 0xCE: ADC A, d8 (Z 0 H C)
-void op_adc_a_d8(GameBoy *gb, const uint8_t operand) { REG(A) = add_byte_carry(gb, REG(A), operand); }
+void op_adc_a_d8(GameBoy *gb) { REG(A) = add_byte_carry(gb, REG(A), FETCH8()); }
 
 // 0xCF: RST 08H (- - - -)
 void op_rst_08h(GameBoy *gb) {
@@ -884,16 +915,20 @@ void op_pop_de(GameBoy *gb) {
 }
 
 // 0xD2: JP NC, a16 (- - - -)
-void op_jp_nc_a16(GameBoy *gb, const uint16_t operand) {
+void op_jp_nc_a16(GameBoy *gb) {
+    const uint16_t operand = FETCH16();
+
     if (!FGET(FLAG_CARRY)) {
-        op_jp_a16(gb, operand);
+        jump(gb, operand);
     }
 }
 
 // 0xD4: CALL NC, a16 (- - - -)
-void op_call_nc_a16(GameBoy *gb, const uint16_t operand) {
+void op_call_nc_a16(GameBoy *gb) {
+    const uint16_t operand = FETCH16();
+
     if (!FGET(FLAG_CARRY)) {
-        op_call_a16(gb, operand);
+        call(gb, operand);
     }
 }
 
@@ -904,7 +939,7 @@ void op_push_de(GameBoy *gb) {
 }
 
 // 0xD6: SUB d8 (Z 1 H C)
-void op_sub_d8(GameBoy *gb, const uint8_t operand) { REG(A) = sub_byte(gb, REG(A), operand); }
+void op_sub_d8(GameBoy *gb) { REG(A) = sub_byte(gb, REG(A), FETCH8()); }
 
 // 0xD7: RST 10H (- - - -)
 void op_rst_10h(GameBoy *gb) {
@@ -929,21 +964,25 @@ void op_reti(GameBoy *gb) {
 }
 
 // 0xDA: JP C, a16 (- - - -)
-void op_jp_c_a16(GameBoy *gb, const uint16_t operand) {
+void op_jp_c_a16(GameBoy *gb) {
+    const uint16_t operand = FETCH16();
+
     if (FGET(FLAG_CARRY)) {
-        op_jp_a16(gb, operand);
+        jump(gb, operand);
     }
 }
 
 // 0xDC: CALL C, a16 (- - - -)
-void op_call_c_a16(GameBoy *gb, const uint16_t operand) {
+void op_call_c_a16(GameBoy *gb) {
+    const uint16_t operand = FETCH16();
+
     if (FGET(FLAG_CARRY)) {
-        op_call_a16(gb, operand);
+        call(gb, operand);
     }
 }
 
 // 0xDE: SBC A, d8 (Z 1 H C)
-void op_sbc_a_d8(GameBoy *gb, const uint8_t operand) { REG(A) = sub_byte_carry(gb, REG(A), operand); }
+void op_sbc_a_d8(GameBoy *gb) { REG(A) = sub_byte_carry(gb, REG(A), FETCH8()); }
 
 // 0xDF: RST 18H (- - - -)
 void op_rst_18h(GameBoy *gb) {
@@ -953,7 +992,8 @@ void op_rst_18h(GameBoy *gb) {
 }
 
 // 0xE0: LDH (a8), A (- - - -)
-void op_ldh_a8p_a(GameBoy *gb, const uint8_t operand) {
+void op_ldh_a8p_a(GameBoy *gb) {
+    const uint8_t operand = FETCH8();
     WRITE8(0xFF00 + operand, REG(A));
     TICK(1);
 }
@@ -977,7 +1017,7 @@ void op_push_hl(GameBoy *gb) {
 }
 
 // 0xE6: AND d8 (Z 0 1 0)
-void op_and_d8(GameBoy *gb, const uint8_t operand) { REG(A) = and(gb, REG(A), operand); }
+void op_and_d8(GameBoy *gb) { REG(A) = and(gb, REG(A), FETCH8()); }
 
 // 0xE7: RST 20H (- - - -)
 void op_rst_20h(GameBoy *gb) {
@@ -987,7 +1027,8 @@ void op_rst_20h(GameBoy *gb) {
 }
 
 // 0xE8: ADD SP, r8 (0 0 H C)
-void op_add_sp_r8(GameBoy *gb, const int8_t operand) {
+void op_add_sp_r8(GameBoy *gb) {
+    const int8_t operand = FETCH8();
     REG(SP) = add_sp_signed_byte(gb, REG(SP), operand);
     TICK(2);
 }
@@ -996,13 +1037,14 @@ void op_add_sp_r8(GameBoy *gb, const int8_t operand) {
 void op_jp_hlp(GameBoy *gb) { REG(PC) = REG(HL); }
 
 // 0xEA: LD (a16), A (- - - -)
-void op_ld_a16p_a(GameBoy *gb, const uint16_t operand) {
+void op_ld_a16p_a(GameBoy *gb) {
+    const uint16_t operand = FETCH16();
     WRITE8(operand, REG(A));
     TICK(1);
 }
 
 // 0xEE: XOR d8 (Z 0 0 0)
-void op_xor_d8(GameBoy *gb, const uint8_t operand) { REG(A) = xor(gb, operand, REG(A)); }
+void op_xor_d8(GameBoy *gb) { REG(A) = xor(gb, FETCH8(), REG(A)); }
 
 // 0xEF: RST 28H (- - - -)
 void op_rst_28h(GameBoy *gb) {
@@ -1012,7 +1054,8 @@ void op_rst_28h(GameBoy *gb) {
 }
 
 // 0xF0: LDH A, (a8) (- - - -)
-void op_ldh_a_a8p(GameBoy *gb, const uint8_t operand) {
+void op_ldh_a_a8p(GameBoy *gb) {
+    const uint8_t operand = FETCH8();
     REG(A) = READ8(0xFF00 + operand);
     TICK(1);
 }
@@ -1023,6 +1066,7 @@ void op_pop_af(GameBoy *gb) {
     TICK(2);
     // The unused bits are cleared
     REG(F) &= 0xF0;
+    gb->cpu.flags.op = FlagsEvaluated;
 }
 
 // 0xF2: LD A, (C) (- - - -)
@@ -1036,12 +1080,13 @@ void op_di(GameBoy *gb) { REG(IME) = false; }
 
 // 0xF5: PUSH AF (- - - -)
 void op_push_af(GameBoy *gb) {
+    evaluate_flags(gb);
     PUSH16(REG(AF));
     TICK(3);
 }
 
 // 0xF6: OR d8 (Z 0 0 0)
-void op_or_d8(GameBoy *gb, const uint8_t operand) { REG(A) = or (gb, REG(A), operand); }
+void op_or_d8(GameBoy *gb) { REG(A) = or (gb, REG(A), FETCH8()); }
 
 // 0xF7: RST 30H (- - - -)
 void op_rst_30h(GameBoy *gb) {
@@ -1051,7 +1096,8 @@ void op_rst_30h(GameBoy *gb) {
 }
 
 // 0xF8: LD HL, SP+r8 (0 0 H C)
-void op_ld_hl_sppr8(GameBoy *gb, const int8_t operand) {
+void op_ld_hl_sppr8(GameBoy *gb) {
+    const int8_t operand = FETCH8();
     REG(HL) = add_sp_signed_byte(gb, REG(SP), operand);
     TICK(1);
 }
@@ -1063,7 +1109,8 @@ void op_ld_sp_hl(GameBoy *gb) {
 }
 
 // 0xFA: LD A, (a16) (- - - -)
-void op_ld_a_a16p(GameBoy *gb, const uint16_t operand) {
+void op_ld_a_a16p(GameBoy *gb) {
+    const uint16_t operand = FETCH16();
     REG(A) = READ8(operand);
     TICK(1);
 }
@@ -1072,7 +1119,7 @@ void op_ld_a_a16p(GameBoy *gb, const uint16_t operand) {
 void op_ei(GameBoy *gb) { REG(IME) = true; }
 
 // 0xFE: CP d8 (Z 1 H C)
-void op_cp_d8(GameBoy *gb, const uint8_t operand) { sub_byte(gb, REG(A), operand); }
+void op_cp_d8(GameBoy *gb) { sub_byte(gb, REG(A), FETCH8()); }
 
 // 0xFF: RST 38H (- - - -)
 void op_rst_38h(GameBoy *gb) {
@@ -1081,914 +1128,85 @@ void op_rst_38h(GameBoy *gb) {
     TICK(3);
 }
 
-// 0xCB00: RLC B (Z 0 0 C)
-void op_rlc_b(GameBoy *gb) { REG(B) = rotate_left_carry(gb, REG(B), true); }
-
-// 0xCB01: RLC C (Z 0 0 C)
-void op_rlc_c(GameBoy *gb) { REG(C) = rotate_left_carry(gb, REG(C), true); }
-
-// 0xCB02: RLC D (Z 0 0 C)
-void op_rlc_d(GameBoy *gb) { REG(D) = rotate_left_carry(gb, REG(D), true); }
-
-// 0xCB03: RLC E (Z 0 0 C)
-void op_rlc_e(GameBoy *gb) { REG(E) = rotate_left_carry(gb, REG(E), true); }
-
-// 0xCB04: RLC H (Z 0 0 C)
-void op_rlc_h(GameBoy *gb) { REG(H) = rotate_left_carry(gb, REG(H), true); }
-
-// 0xCB05: RLC L (Z 0 0 C)
-void op_rlc_l(GameBoy *gb) { REG(L) = rotate_left_carry(gb, REG(L), true); }
-
-// 0xCB06: RLC (HL) (Z 0 0 C)
-void op_rlc_hlp(GameBoy *gb) {
-    const uint8_t hl = READ8(REG(HL));
-    TICK(1);
-    WRITE8(REG(HL), rotate_left_carry(gb, hl, true));
-    TICK(1);
-}
-
-// 0xCB07: RLC A (Z 0 0 C)
-void op_rlc_a(GameBoy *gb) { REG(A) = rotate_left_carry(gb, REG(A), true); }
-
-// 0xCB08: RRC B (Z 0 0 C)
-void op_rrc_b(GameBoy *gb) { REG(B) = rotate_right_carry(gb, REG(B), true); }
-
-// 0xCB09: RRC C (Z 0 0 C)
-void op_rrc_c(GameBoy *gb) { REG(C) = rotate_right_carry(gb, REG(C), true); }
-
-// 0xCB0A: RRC D (Z 0 0 C)
-void op_rrc_d(GameBoy *gb) { REG(D) = rotate_right_carry(gb, REG(D), true); }
-
-// 0xCB0B: RRC E (Z 0 0 C)
-void op_rrc_e(GameBoy *gb) { REG(E) = rotate_right_carry(gb, REG(E), true); }
-
-// 0xCB0C: RRC H (Z 0 0 C)
-void op_rrc_h(GameBoy *gb) { REG(H) = rotate_right_carry(gb, REG(H), true); }
-
-// 0xCB0D: RRC L (Z 0 0 C)
-void op_rrc_l(GameBoy *gb) { REG(L) = rotate_right_carry(gb, REG(L), true); }
-
-// 0xCB0E: RRC (HL) (Z 0 0 C)
-void op_rrc_hlp(GameBoy *gb) {
-    const uint8_t hl = READ8(REG(HL));
-    TICK(1);
-    WRITE8(REG(HL), rotate_right_carry(gb, hl, true));
-    TICK(1);
-}
-
-// 0xCB0F: RRC A (Z 0 0 C)
-void op_rrc_a(GameBoy *gb) { REG(A) = rotate_right_carry(gb, REG(A), true); }
-
-// 0xCB10: RL B (Z 0 0 C)
-void op_rl_b(GameBoy *gb) { REG(B) = rotate_left(gb, REG(B), true); }
-
-// 0xCB11: RL C (Z 0 0 C)
-void op_rl_c(GameBoy *gb) { REG(C) = rotate_left(gb, REG(C), true); }
-
-// 0xCB12: RL D (Z 0 0 C)
-void op_rl_d(GameBoy *gb) { REG(D) = rotate_left(gb, REG(D), true); }
-
-// 0xCB13: RL E (Z 0 0 C)
-void op_rl_e(GameBoy *gb) { REG(E) = rotate_left(gb, REG(E), true); }
-
-// 0xCB14: RL H (Z 0 0 C)
-void op_rl_h(GameBoy *gb) { REG(H) = rotate_left(gb, REG(H), true); }
-
-// 0xCB15: RL L (Z 0 0 C)
-void op_rl_l(GameBoy *gb) { REG(L) = rotate_left(gb, REG(L), true); }
-
-// 0xCB16: RL (HL) (Z 0 0 C)
-void op_rl_hlp(GameBoy *gb) {
-    const uint8_t hl = READ8(REG(HL));
-    TICK(1);
-    WRITE8(REG(HL), rotate_left(gb, hl, true));
-    TICK(1);
-}
-
-// 0xCB17: RL A (Z 0 0 C)
-void op_rl_a(GameBoy *gb) { REG(A) = rotate_left(gb, REG(A), true); }
-
-// 0xCB18: RR B (Z 0 0 C)
-void op_rr_b(GameBoy *gb) { REG(B) = rotate_right(gb, REG(B)); }
-
-// 0xCB19: RR C (Z 0 0 C)
-void op_rr_c(GameBoy *gb) { REG(C) = rotate_right(gb, REG(C)); }
-
-// 0xCB1A: RR D (Z 0 0 C)
-void op_rr_d(GameBoy *gb) { REG(D) = rotate_right(gb, REG(D)); }
-
-// 0xCB1B: RR E (Z 0 0 C)
-void op_rr_e(GameBoy *gb) { REG(E) = rotate_right(gb, REG(E)); }
-
-// 0xCB1C: RR H (Z 0 0 C)
-void op_rr_h(GameBoy *gb) { REG(H) = rotate_right(gb, REG(H)); }
-
-// 0xCB1D: RR L (Z 0 0 C)
-void op_rr_l(GameBoy *gb) { REG(L) = rotate_right(gb, REG(L)); }
-
-// 0xCB1E: RR (HL) (Z 0 0 C)
-void op_rr_hlp(GameBoy *gb) {
-    const uint8_t hl = READ8(REG(HL));
-    TICK(1);
-    WRITE8(REG(HL), rotate_right(gb, hl));
-    TICK(1);
-}
-
-// 0xCB1F: RR A (Z 0 0 C)
-void op_rr_a(GameBoy *gb) { REG(A) = rotate_right(gb, REG(A)); }
-
-// 0xCB20: SLA B (Z 0 0 C)
-void op_sla_b(GameBoy *gb) { REG(B) = shift_left_arith(gb, REG(B)); }
-
-// 0xCB21: SLA C (Z 0 0 C)
-void op_sla_c(GameBoy *gb) { REG(C) = shift_left_arith(gb, REG(C)); }
-
-// 0xCB22: SLA D (Z 0 0 C)
-void op_sla_d(GameBoy *gb) { REG(D) = shift_left_arith(gb, REG(D)); }
-
-// 0xCB23: SLA E (Z 0 0 C)
-void op_sla_e(GameBoy *gb) { REG(E) = shift_left_arith(gb, REG(E)); }
-
-// 0xCB24: SLA H (Z 0 0 C)
-void op_sla_h(GameBoy *gb) { REG(H) = shift_left_arith(gb, REG(H)); }
-
-// 0xCB25: SLA L (Z 0 0 C)
-void op_sla_l(GameBoy *gb) { REG(L) = shift_left_arith(gb, REG(L)); }
-
-// 0xCB26: SLA (HL) (Z 0 0 C)
-void op_sla_hlp(GameBoy *gb) {
-    const uint8_t hl = READ8(REG(HL));
-    TICK(1);
-    WRITE8(REG(HL), shift_left_arith(gb, hl));
-    TICK(1);
-}
-
-// 0xCB27: SLA A (Z 0 0 C)
-void op_sla_a(GameBoy *gb) { REG(A) = shift_left_arith(gb, REG(A)); }
-
-// 0xCB28: SRA B (Z 0 0 0)
-void op_sra_b(GameBoy *gb) { REG(B) = shift_right_arith(gb, REG(B)); }
-
-// 0xCB29: SRA C (Z 0 0 0)
-void op_sra_c(GameBoy *gb) { REG(C) = shift_right_arith(gb, REG(C)); }
-
-// 0xCB2A: SRA D (Z 0 0 0)
-void op_sra_d(GameBoy *gb) { REG(D) = shift_right_arith(gb, REG(D)); }
-
-// 0xCB2B: SRA E (Z 0 0 0)
-void op_sra_e(GameBoy *gb) { REG(E) = shift_right_arith(gb, REG(E)); }
-
-// 0xCB2C: SRA H (Z 0 0 0)
-void op_sra_h(GameBoy *gb) { REG(H) = shift_right_arith(gb, REG(H)); }
-
-// 0xCB2D: SRA L (Z 0 0 0)
-void op_sra_l(GameBoy *gb) { REG(L) = shift_right_arith(gb, REG(L)); }
-
-// 0xCB2E: SRA (HL) (Z 0 0 0)
-void op_sra_hlp(GameBoy *gb) {
-    const uint8_t hl = READ8(REG(HL));
-    TICK(1);
-    WRITE8(REG(HL), shift_right_arith(gb, hl));
-    TICK(1);
-}
-
-// 0xCB2F: SRA A (Z 0 0 0)
-void op_sra_a(GameBoy *gb) { REG(A) = shift_right_arith(gb, REG(A)); }
-
-// 0xCB30: SWAP B (Z 0 0 0)
-void op_swap_b(GameBoy *gb) { REG(B) = swap(gb, REG(B)); }
-
-// 0xCB31: SWAP C (Z 0 0 0)
-void op_swap_c(GameBoy *gb) { REG(C) = swap(gb, REG(C)); }
-
-// 0xCB32: SWAP D (Z 0 0 0)
-void op_swap_d(GameBoy *gb) { REG(D) = swap(gb, REG(D)); }
-
-// 0xCB33: SWAP E (Z 0 0 0)
-void op_swap_e(GameBoy *gb) { REG(E) = swap(gb, REG(E)); }
-
-// 0xCB34: SWAP H (Z 0 0 0)
-void op_swap_h(GameBoy *gb) { REG(H) = swap(gb, REG(H)); }
-
-// 0xCB35: SWAP L (Z 0 0 0)
-void op_swap_l(GameBoy *gb) { REG(L) = swap(gb, REG(L)); }
-
-// 0xCB36: SWAP (HL) (Z 0 0 0)
-void op_swap_hlp(GameBoy *gb) {
-    const uint8_t hl = READ8(REG(HL));
-    TICK(1);
-    WRITE8(REG(HL), swap(gb, hl));
-    TICK(1);
-}
-
-// 0xCB37: SWAP A (Z 0 0 0)
-void op_swap_a(GameBoy *gb) { REG(A) = swap(gb, REG(A)); }
-
-// 0xCB38: SRL B (Z 0 0 C)
-void op_srl_b(GameBoy *gb) { REG(B) = shift_right_logic(gb, REG(B)); }
-
-// 0xCB39: SRL C (Z 0 0 C)
-void op_srl_c(GameBoy *gb) { REG(C) = shift_right_logic(gb, REG(C)); }
-
-// 0xCB3A: SRL D (Z 0 0 C)
-void op_srl_d(GameBoy *gb) { REG(D) = shift_right_logic(gb, REG(D)); }
-
-// 0xCB3B: SRL E (Z 0 0 C)
-void op_srl_e(GameBoy *gb) { REG(E) = shift_right_logic(gb, REG(E)); }
-
-// 0xCB3C: SRL H (Z 0 0 C)
-void op_srl_h(GameBoy *gb) { REG(H) = shift_right_logic(gb, REG(H)); }
-
-// 0xCB3D: SRL L (Z 0 0 C)
-void op_srl_l(GameBoy *gb) { REG(L) = shift_right_logic(gb, REG(L)); }
-
-// 0xCB3E: SRL (HL) (Z 0 0 C)
-void op_srl_hlp(GameBoy *gb) {
-    const uint8_t hl = READ8(REG(HL));
-    TICK(1);
-    WRITE8(REG(HL), shift_right_logic(gb, hl));
-    TICK(1);
-}
-
-// 0xCB3F: SRL A (Z 0 0 C)
-void op_srl_a(GameBoy *gb) { REG(A) = shift_right_logic(gb, REG(A)); }
-
-// 0xCB40: BIT 0, B (Z 0 1 -)
-void op_bit_0_b(GameBoy *gb) { test_bit(gb, REG(B), 0); }
-
-// 0xCB41: BIT 0, C (Z 0 1 -)
-void op_bit_0_c(GameBoy *gb) { test_bit(gb, REG(C), 0); }
-
-// 0xCB42: BIT 0, D (Z 0 1 -)
-void op_bit_0_d(GameBoy *gb) { test_bit(gb, REG(D), 0); }
-
-// 0xCB43: BIT 0, E (Z 0 1 -)
-void op_bit_0_e(GameBoy *gb) { test_bit(gb, REG(E), 0); }
-
-// 0xCB44: BIT 0, H (Z 0 1 -)
-void op_bit_0_h(GameBoy *gb) { test_bit(gb, REG(H), 0); }
-
-// 0xCB45: BIT 0, L (Z 0 1 -)
-void op_bit_0_l(GameBoy *gb) { test_bit(gb, REG(L), 0); }
-
-// 0xCB46: BIT 0, (HL) (Z 0 1 -)
-void op_bit_0_hlp(GameBoy *gb) {
-    test_bit(gb, READ8(REG(HL)), 0);
-    TICK(1);
-}
-
-// 0xCB47: BIT 0, A (Z 0 1 -)
-void op_bit_0_a(GameBoy *gb) { test_bit(gb, REG(A), 0); }
-
-// 0xCB48: BIT 1, B (Z 0 1 -)
-void op_bit_1_b(GameBoy *gb) { test_bit(gb, REG(B), 1); }
-
-// 0xCB49: BIT 1, C (Z 0 1 -)
-void op_bit_1_c(GameBoy *gb) { test_bit(gb, REG(C), 1); }
-
-// 0xCB4A: BIT 1, D (Z 0 1 -)
-void op_bit_1_d(GameBoy *gb) { test_bit(gb, REG(D), 1); }
-
-// 0xCB4B: BIT 1, E (Z 0 1 -)
-void op_bit_1_e(GameBoy *gb) { test_bit(gb, REG(E), 1); }
-
-// 0xCB4C: BIT 1, H (Z 0 1 -)
-void op_bit_1_h(GameBoy *gb) { test_bit(gb, REG(H), 1); }
-
-// 0xCB4D: BIT 1, L (Z 0 1 -)
-void op_bit_1_l(GameBoy *gb) { test_bit(gb, REG(L), 1); }
-
-// 0xCB4E: BIT 1, (HL) (Z 0 1 -)
-void op_bit_1_hlp(GameBoy *gb) {
-    test_bit(gb, READ8(REG(HL)), 1);
-    TICK(1);
-}
-
-// 0xCB4F: BIT 1, A (Z 0 1 -)
-void op_bit_1_a(GameBoy *gb) { test_bit(gb, REG(A), 1); }
-
-// 0xCB50: BIT 2, B (Z 0 1 -)
-void op_bit_2_b(GameBoy *gb) { test_bit(gb, REG(B), 2); }
-
-// 0xCB51: BIT 2, C (Z 0 1 -)
-void op_bit_2_c(GameBoy *gb) { test_bit(gb, REG(C), 2); }
-
-// 0xCB52: BIT 2, D (Z 0 1 -)
-void op_bit_2_d(GameBoy *gb) { test_bit(gb, REG(D), 2); }
-
-// 0xCB53: BIT 2, E (Z 0 1 -)
-void op_bit_2_e(GameBoy *gb) { test_bit(gb, REG(E), 2); }
-
-// 0xCB54: BIT 2, H (Z 0 1 -)
-void op_bit_2_h(GameBoy *gb) { test_bit(gb, REG(H), 2); }
-
-// 0xCB55: BIT 2, L (Z 0 1 -)
-void op_bit_2_l(GameBoy *gb) { test_bit(gb, REG(L), 2); }
-
-// 0xCB56: BIT 2, (HL) (Z 0 1 -)
-void op_bit_2_hlp(GameBoy *gb) {
-    test_bit(gb, READ8(REG(HL)), 2);
-    TICK(1);
-}
-
-// 0xCB57: BIT 2, A (Z 0 1 -)
-void op_bit_2_a(GameBoy *gb) { test_bit(gb, REG(A), 2); }
-
-// 0xCB58: BIT 3, B (Z 0 1 -)
-void op_bit_3_b(GameBoy *gb) { test_bit(gb, REG(B), 3); }
-
-// 0xCB59: BIT 3, C (Z 0 1 -)
-void op_bit_3_c(GameBoy *gb) { test_bit(gb, REG(C), 3); }
-
-// 0xCB5A: BIT 3, D (Z 0 1 -)
-void op_bit_3_d(GameBoy *gb) { test_bit(gb, REG(D), 3); }
-
-// 0xCB5B: BIT 3, E (Z 0 1 -)
-void op_bit_3_e(GameBoy *gb) { test_bit(gb, REG(E), 3); }
-
-// 0xCB5C: BIT 3, H (Z 0 1 -)
-void op_bit_3_h(GameBoy *gb) { test_bit(gb, REG(H), 3); }
-
-// 0xCB5D: BIT 3, L (Z 0 1 -)
-void op_bit_3_l(GameBoy *gb) { test_bit(gb, REG(L), 3); }
-
-// 0xCB5E: BIT 3, (HL) (Z 0 1 -)
-void op_bit_3_hlp(GameBoy *gb) {
-    test_bit(gb, READ8(REG(HL)), 3);
-    TICK(1);
-}
-
-// 0xCB5F: BIT 3, A (Z 0 1 -)
-void op_bit_3_a(GameBoy *gb) { test_bit(gb, REG(A), 3); }
-
-// 0xCB60: BIT 4, B (Z 0 1 -)
-void op_bit_4_b(GameBoy *gb) { test_bit(gb, REG(B), 4); }
-
-// 0xCB61: BIT 4, C (Z 0 1 -)
-void op_bit_4_c(GameBoy *gb) { test_bit(gb, REG(C), 4); }
-
-// 0xCB62: BIT 4, D (Z 0 1 -)
-void op_bit_4_d(GameBoy *gb) { test_bit(gb, REG(D), 4); }
-
-// 0xCB63: BIT 4, E (Z 0 1 -)
-void op_bit_4_e(GameBoy *gb) { test_bit(gb, REG(E), 4); }
-
-// 0xCB64: BIT 4, H (Z 0 1 -)
-void op_bit_4_h(GameBoy *gb) { test_bit(gb, REG(H), 4); }
-
-// 0xCB65: BIT 4, L (Z 0 1 -)
-void op_bit_4_l(GameBoy *gb) { test_bit(gb, REG(L), 4); }
-
-// 0xCB66: BIT 4, (HL) (Z 0 1 -)
-void op_bit_4_hlp(GameBoy *gb) {
-    test_bit(gb, READ8(REG(HL)), 4);
-    TICK(1);
-}
-
-// 0xCB67: BIT 4, A (Z 0 1 -)
-void op_bit_4_a(GameBoy *gb) { test_bit(gb, REG(A), 4); }
-
-// 0xCB68: BIT 5, B (Z 0 1 -)
-void op_bit_5_b(GameBoy *gb) { test_bit(gb, REG(B), 5); }
-
-// 0xCB69: BIT 5, C (Z 0 1 -)
-void op_bit_5_c(GameBoy *gb) { test_bit(gb, REG(C), 5); }
-
-// 0xCB6A: BIT 5, D (Z 0 1 -)
-void op_bit_5_d(GameBoy *gb) { test_bit(gb, REG(D), 5); }
-
-// 0xCB6B: BIT 5, E (Z 0 1 -)
-void op_bit_5_e(GameBoy *gb) { test_bit(gb, REG(E), 5); }
-
-// 0xCB6C: BIT 5, H (Z 0 1 -)
-void op_bit_5_h(GameBoy *gb) { test_bit(gb, REG(H), 5); }
-
-// 0xCB6D: BIT 5, L (Z 0 1 -)
-void op_bit_5_l(GameBoy *gb) { test_bit(gb, REG(L), 5); }
-
-// 0xCB6E: BIT 5, (HL) (Z 0 1 -)
-void op_bit_5_hlp(GameBoy *gb) {
-    test_bit(gb, READ8(REG(HL)), 5);
-    TICK(1);
-}
-
-// 0xCB6F: BIT 5, A (Z 0 1 -)
-void op_bit_5_a(GameBoy *gb) { test_bit(gb, REG(A), 5); }
-
-// 0xCB70: BIT 6, B (Z 0 1 -)
-void op_bit_6_b(GameBoy *gb) { test_bit(gb, REG(B), 6); }
-
-// 0xCB71: BIT 6, C (Z 0 1 -)
-void op_bit_6_c(GameBoy *gb) { test_bit(gb, REG(C), 6); }
-
-// 0xCB72: BIT 6, D (Z 0 1 -)
-void op_bit_6_d(GameBoy *gb) { test_bit(gb, REG(D), 6); }
-
-// 0xCB73: BIT 6, E (Z 0 1 -)
-void op_bit_6_e(GameBoy *gb) { test_bit(gb, REG(E), 6); }
-
-// 0xCB74: BIT 6, H (Z 0 1 -)
-void op_bit_6_h(GameBoy *gb) { test_bit(gb, REG(H), 6); }
-
-// 0xCB75: BIT 6, L (Z 0 1 -)
-void op_bit_6_l(GameBoy *gb) { test_bit(gb, REG(L), 6); }
-
-// 0xCB76: BIT 6, (HL) (Z 0 1 -)
-void op_bit_6_hlp(GameBoy *gb) {
-    test_bit(gb, READ8(REG(HL)), 6);
-    TICK(1);
-}
-
-// 0xCB77: BIT 6, A (Z 0 1 -)
-void op_bit_6_a(GameBoy *gb) { test_bit(gb, REG(A), 6); }
-
-// 0xCB78: BIT 7, B (Z 0 1 -)
-void op_bit_7_b(GameBoy *gb) { test_bit(gb, REG(B), 7); }
-
-// 0xCB79: BIT 7, C (Z 0 1 -)
-void op_bit_7_c(GameBoy *gb) { test_bit(gb, REG(C), 7); }
-
-// 0xCB7A: BIT 7, D (Z 0 1 -)
-void op_bit_7_d(GameBoy *gb) { test_bit(gb, REG(D), 7); }
-
-// 0xCB7B: BIT 7, E (Z 0 1 -)
-void op_bit_7_e(GameBoy *gb) { test_bit(gb, REG(E), 7); }
-
-// 0xCB7C: BIT 7, H (Z 0 1 -)
-void op_bit_7_h(GameBoy *gb) { test_bit(gb, REG(H), 7); }
-
-// 0xCB7D: BIT 7, L (Z 0 1 -)
-void op_bit_7_l(GameBoy *gb) { test_bit(gb, REG(L), 7); }
-
-// 0xCB7E: BIT 7, (HL) (Z 0 1 -)
-void op_bit_7_hlp(GameBoy *gb) {
-    test_bit(gb, READ8(REG(HL)), 7);
-    TICK(1);
-}
-
-// 0xCB7F: BIT 7, A (Z 0 1 -)
-void op_bit_7_a(GameBoy *gb) { test_bit(gb, REG(A), 7); }
-
-// 0xCB80: RES 0, B (- - - -)
-void op_res_0_b(GameBoy *gb) { REG(B) = reset_bit(REG(B), 0); }
-
-// 0xCB81: RES 0, C (- - - -)
-void op_res_0_c(GameBoy *gb) { REG(C) = reset_bit(REG(C), 0); }
-
-// 0xCB82: RES 0, D (- - - -)
-void op_res_0_d(GameBoy *gb) { REG(D) = reset_bit(REG(D), 0); }
-
-// 0xCB83: RES 0, E (- - - -)
-void op_res_0_e(GameBoy *gb) { REG(E) = reset_bit(REG(E), 0); }
-
-// 0xCB84: RES 0, H (- - - -)
-void op_res_0_h(GameBoy *gb) { REG(H) = reset_bit(REG(H), 0); }
-
-// 0xCB85: RES 0, L (- - - -)
-void op_res_0_l(GameBoy *gb) { REG(L) = reset_bit(REG(L), 0); }
-
-// 0xCB86: RES 0, (HL) (- - - -)
-void op_res_0_hlp(GameBoy *gb) {
-    const uint8_t hl = READ8(REG(HL));
-    TICK(1);
-    WRITE8(REG(HL), reset_bit(hl, 0));
-    TICK(1);
-}
-
-// 0xCB87: RES 0, A (- - - -)
-void op_res_0_a(GameBoy *gb) { REG(A) = reset_bit(REG(A), 0); }
-
-// 0xCB88: RES 1, B (- - - -)
-void op_res_1_b(GameBoy *gb) { REG(B) = reset_bit(REG(B), 1); }
-
-// 0xCB89: RES 1, C (- - - -)
-void op_res_1_c(GameBoy *gb) { REG(C) = reset_bit(REG(C), 1); }
-
-// 0xCB8A: RES 1, D (- - - -)
-void op_res_1_d(GameBoy *gb) { REG(D) = reset_bit(REG(D), 1); }
-
-// 0xCB8B: RES 1, E (- - - -)
-void op_res_1_e(GameBoy *gb) { REG(E) = reset_bit(REG(E), 1); }
-
-// 0xCB8C: RES 1, H (- - - -)
-void op_res_1_h(GameBoy *gb) { REG(H) = reset_bit(REG(H), 1); }
-
-// 0xCB8D: RES 1, L (- - - -)
-void op_res_1_l(GameBoy *gb) { REG(L) = reset_bit(REG(L), 1); }
-
-// 0xCB8E: RES 1, (HL) (- - - -)
-void op_res_1_hlp(GameBoy *gb) {
-    const uint8_t hl = READ8(REG(HL));
-    TICK(1);
-    WRITE8(REG(HL), reset_bit(hl, 1));
-    TICK(1);
-}
-
-// 0xCB8F: RES 1, A (- - - -)
-void op_res_1_a(GameBoy *gb) { REG(A) = reset_bit(REG(A), 1); }
-
-// 0xCB90: RES 2, B (- - - -)
-void op_res_2_b(GameBoy *gb) { REG(B) = reset_bit(REG(B), 2); }
-
-// 0xCB91: RES 2, C (- - - -)
-void op_res_2_c(GameBoy *gb) { REG(C) = reset_bit(REG(C), 2); }
-
-// 0xCB92: RES 2, D (- - - -)
-void op_res_2_d(GameBoy *gb) { REG(D) = reset_bit(REG(D), 2); }
-
-// 0xCB93: RES 2, E (- - - -)
-void op_res_2_e(GameBoy *gb) { REG(E) = reset_bit(REG(E), 2); }
-
-// 0xCB94: RES 2, H (- - - -)
-void op_res_2_h(GameBoy *gb) { REG(H) = reset_bit(REG(H), 2); }
-
-// 0xCB95: RES 2, L (- - - -)
-void op_res_2_l(GameBoy *gb) { REG(L) = reset_bit(REG(L), 2); }
-
-// 0xCB96: RES 2, (HL) (- - - -)
-void op_res_2_hlp(GameBoy *gb) {
-    const uint8_t hl = READ8(REG(HL));
-    TICK(1);
-    WRITE8(REG(HL), reset_bit(hl, 2));
-    TICK(1);
-}
-
-// 0xCB97: RES 2, A (- - - -)
-void op_res_2_a(GameBoy *gb) { REG(A) = reset_bit(REG(A), 2); }
-
-// 0xCB98: RES 3, B (- - - -)
-void op_res_3_b(GameBoy *gb) { REG(B) = reset_bit(REG(B), 3); }
-
-// 0xCB99: RES 3, C (- - - -)
-void op_res_3_c(GameBoy *gb) { REG(C) = reset_bit(REG(C), 3); }
-
-// 0xCB9A: RES 3, D (- - - -)
-void op_res_3_d(GameBoy *gb) { REG(D) = reset_bit(REG(D), 3); }
-
-// 0xCB9B: RES 3, E (- - - -)
-void op_res_3_e(GameBoy *gb) { REG(E) = reset_bit(REG(E), 3); }
-
-// 0xCB9C: RES 3, H (- - - -)
-void op_res_3_h(GameBoy *gb) { REG(H) = reset_bit(REG(H), 3); }
-
-// 0xCB9D: RES 3, L (- - - -)
-void op_res_3_l(GameBoy *gb) { REG(L) = reset_bit(REG(L), 3); }
-
-// 0xCB9E: RES 3, (HL) (- - - -)
-void op_res_3_hlp(GameBoy *gb) {
-    const uint8_t hl = READ8(REG(HL));
-    TICK(1);
-    WRITE8(REG(HL), reset_bit(hl, 3));
-    TICK(1);
-}
-
-// 0xCB9F: RES 3, A (- - - -)
-void op_res_3_a(GameBoy *gb) { REG(A) = reset_bit(REG(A), 3); }
-
-// 0xCBA0: RES 4, B (- - - -)
-void op_res_4_b(GameBoy *gb) { REG(B) = reset_bit(REG(B), 4); }
-
-// 0xCBA1: RES 4, C (- - - -)
-void op_res_4_c(GameBoy *gb) { REG(C) = reset_bit(REG(C), 4); }
-
-// 0xCBA2: RES 4, D (- - - -)
-void op_res_4_d(GameBoy *gb) { REG(D) = reset_bit(REG(D), 4); }
-
-// 0xCBA3: RES 4, E (- - - -)
-void op_res_4_e(GameBoy *gb) { REG(E) = reset_bit(REG(E), 4); }
-
-// 0xCBA4: RES 4, H (- - - -)
-void op_res_4_h(GameBoy *gb) { REG(H) = reset_bit(REG(H), 4); }
-
-// 0xCBA5: RES 4, L (- - - -)
-void op_res_4_l(GameBoy *gb) { REG(L) = reset_bit(REG(L), 4); }
-
-// 0xCBA6: RES 4, (HL) (- - - -)
-void op_res_4_hlp(GameBoy *gb) {
-    const uint8_t hl = READ8(REG(HL));
-    TICK(1);
-    WRITE8(REG(HL), reset_bit(hl, 4));
-    TICK(1);
-}
-
-// 0xCBA7: RES 4, A (- - - -)
-void op_res_4_a(GameBoy *gb) { REG(A) = reset_bit(REG(A), 4); }
-
-// 0xCBA8: RES 5, B (- - - -)
-void op_res_5_b(GameBoy *gb) { REG(B) = reset_bit(REG(B), 5); }
-
-// 0xCBA9: RES 5, C (- - - -)
-void op_res_5_c(GameBoy *gb) { REG(C) = reset_bit(REG(C), 5); }
-
-// 0xCBAA: RES 5, D (- - - -)
-void op_res_5_d(GameBoy *gb) { REG(D) = reset_bit(REG(D), 5); }
-
-// 0xCBAB: RES 5, E (- - - -)
-void op_res_5_e(GameBoy *gb) { REG(E) = reset_bit(REG(E), 5); }
-
-// 0xCBAC: RES 5, H (- - - -)
-void op_res_5_h(GameBoy *gb) { REG(H) = reset_bit(REG(H), 5); }
-
-// 0xCBAD: RES 5, L (- - - -)
-void op_res_5_l(GameBoy *gb) { REG(L) = reset_bit(REG(L), 5); }
-
-// 0xCBAE: RES 5, (HL) (- - - -)
-void op_res_5_hlp(GameBoy *gb) {
-    const uint8_t hl = READ8(REG(HL));
-    TICK(1);
-    WRITE8(REG(HL), reset_bit(hl, 5));
-    TICK(1);
-}
-
-// 0xCBAF: RES 5, A (- - - -)
-void op_res_5_a(GameBoy *gb) { REG(A) = reset_bit(REG(A), 5); }
-
-// 0xCBB0: RES 6, B (- - - -)
-void op_res_6_b(GameBoy *gb) { REG(B) = reset_bit(REG(B), 6); }
-
-// 0xCBB1: RES 6, C (- - - -)
-void op_res_6_c(GameBoy *gb) { REG(C) = reset_bit(REG(C), 6); }
-
-// 0xCBB2: RES 6, D (- - - -)
-void op_res_6_d(GameBoy *gb) { REG(D) = reset_bit(REG(D), 6); }
-
-// 0xCBB3: RES 6, E (- - - -)
-void op_res_6_e(GameBoy *gb) { REG(E) = reset_bit(REG(E), 6); }
-
-// 0xCBB4: RES 6, H (- - - -)
-void op_res_6_h(GameBoy *gb) { REG(H) = reset_bit(REG(H), 6); }
-
-// 0xCBB5: RES 6, L (- - - -)
-void op_res_6_l(GameBoy *gb) { REG(L) = reset_bit(REG(L), 6); }
-
-// 0xCBB6: RES 6, (HL) (- - - -)
-void op_res_6_hlp(GameBoy *gb) {
-    const uint8_t hl = READ8(REG(HL));
-    TICK(1);
-    WRITE8(REG(HL), reset_bit(hl, 6));
-    TICK(1);
-}
-
-// 0xCBB7: RES 6, A (- - - -)
-void op_res_6_a(GameBoy *gb) { REG(A) = reset_bit(REG(A), 6); }
-
-// 0xCBB8: RES 7, B (- - - -)
-void op_res_7_b(GameBoy *gb) { REG(B) = reset_bit(REG(B), 7); }
-
-// 0xCBB9: RES 7, C (- - - -)
-void op_res_7_c(GameBoy *gb) { REG(C) = reset_bit(REG(C), 7); }
-
-// 0xCBBA: RES 7, D (- - - -)
-void op_res_7_d(GameBoy *gb) { REG(D) = reset_bit(REG(D), 7); }
-
-// 0xCBBB: RES 7, E (- - - -)
-void op_res_7_e(GameBoy *gb) { REG(E) = reset_bit(REG(E), 7); }
-
-// 0xCBBC: RES 7, H (- - - -)
-void op_res_7_h(GameBoy *gb) { REG(H) = reset_bit(REG(H), 7); }
-
-// 0xCBBD: RES 7, L (- - - -)
-void op_res_7_l(GameBoy *gb) { REG(L) = reset_bit(REG(L), 7); }
-
-// 0xCBBE: RES 7, (HL) (- - - -)
-void op_res_7_hlp(GameBoy *gb) {
-    const uint8_t hl = READ8(REG(HL));
-    TICK(1);
-    WRITE8(REG(HL), reset_bit(hl, 7));
-    TICK(1);
-}
-
-// 0xCBBF: RES 7, A (- - - -)
-void op_res_7_a(GameBoy *gb) { REG(A) = reset_bit(REG(A), 7); }
-
-// 0xCBC0: SET 0, B (- - - -)
-void op_set_0_b(GameBoy *gb) { REG(B) = set_bit(REG(B), 0); }
-
-// 0xCBC1: SET 0, C (- - - -)
-void op_set_0_c(GameBoy *gb) { REG(C) = set_bit(REG(C), 0); }
-
-// 0xCBC2: SET 0, D (- - - -)
-void op_set_0_d(GameBoy *gb) { REG(D) = set_bit(REG(D), 0); }
-
-// 0xCBC3: SET 0, E (- - - -)
-void op_set_0_e(GameBoy *gb) { REG(E) = set_bit(REG(E), 0); }
-
-// 0xCBC4: SET 0, H (- - - -)
-void op_set_0_h(GameBoy *gb) { REG(H) = set_bit(REG(H), 0); }
-
-// 0xCBC5: SET 0, L (- - - -)
-void op_set_0_l(GameBoy *gb) { REG(L) = set_bit(REG(L), 0); }
-
-// 0xCBC6: SET 0, (HL) (- - - -)
-void op_set_0_hlp(GameBoy *gb) {
-    const uint8_t hl = READ8(REG(HL));
-    TICK(1);
-    WRITE8(REG(HL), set_bit(hl, 0));
-    TICK(1);
-}
-
-// 0xCBC7: SET 0, A (- - - -)
-void op_set_0_a(GameBoy *gb) { REG(A) = set_bit(REG(A), 0); }
-
-// 0xCBC8: SET 1, B (- - - -)
-void op_set_1_b(GameBoy *gb) { REG(B) = set_bit(REG(B), 1); }
-
-// 0xCBC9: SET 1, C (- - - -)
-void op_set_1_c(GameBoy *gb) { REG(C) = set_bit(REG(C), 1); }
-
-// 0xCBCA: SET 1, D (- - - -)
-void op_set_1_d(GameBoy *gb) { REG(D) = set_bit(REG(D), 1); }
-
-// 0xCBCB: SET 1, E (- - - -)
-void op_set_1_e(GameBoy *gb) { REG(E) = set_bit(REG(E), 1); }
-
-// 0xCBCC: SET 1, H (- - - -)
-void op_set_1_h(GameBoy *gb) { REG(H) = set_bit(REG(H), 1); }
-
-// 0xCBCD: SET 1, L (- - - -)
-void op_set_1_l(GameBoy *gb) { REG(L) = set_bit(REG(L), 1); }
-
-// 0xCBCE: SET 1, (HL) (- - - -)
-void op_set_1_hlp(GameBoy *gb) {
-    const uint8_t hl = READ8(REG(HL));
-    TICK(1);
-    WRITE8(REG(HL), set_bit(hl, 1));
-    TICK(1);
-}
-
-// 0xCBCF: SET 1, A (- - - -)
-void op_set_1_a(GameBoy *gb) { REG(A) = set_bit(REG(A), 1); }
-
-// 0xCBD0: SET 2, B (- - - -)
-void op_set_2_b(GameBoy *gb) { REG(B) = set_bit(REG(B), 2); }
-
-// 0xCBD1: SET 2, C (- - - -)
-void op_set_2_c(GameBoy *gb) { REG(C) = set_bit(REG(C), 2); }
-
-// 0xCBD2: SET 2, D (- - - -)
-void op_set_2_d(GameBoy *gb) { REG(D) = set_bit(REG(D), 2); }
-
-// 0xCBD3: SET 2, E (- - - -)
-void op_set_2_e(GameBoy *gb) { REG(E) = set_bit(REG(E), 2); }
-
-// 0xCBD4: SET 2, H (- - - -)
-void op_set_2_h(GameBoy *gb) { REG(H) = set_bit(REG(H), 2); }
-
-// 0xCBD5: SET 2, L (- - - -)
-void op_set_2_l(GameBoy *gb) { REG(L) = set_bit(REG(L), 2); }
-
-// 0xCBD6: SET 2, (HL) (- - - -)
-void op_set_2_hlp(GameBoy *gb) {
-    const uint8_t hl = READ8(REG(HL));
-    TICK(1);
-    WRITE8(REG(HL), set_bit(hl, 2));
-    TICK(1);
-}
-
-// 0xCBD7: SET 2, A (- - - -)
-void op_set_2_a(GameBoy *gb) { REG(A) = set_bit(REG(A), 2); }
-
-// 0xCBD8: SET 3, B (- - - -)
-void op_set_3_b(GameBoy *gb) { REG(B) = set_bit(REG(B), 3); }
-
-// 0xCBD9: SET 3, C (- - - -)
-void op_set_3_c(GameBoy *gb) { REG(C) = set_bit(REG(C), 3); }
-
-// 0xCBDA: SET 3, D (- - - -)
-void op_set_3_d(GameBoy *gb) { REG(D) = set_bit(REG(D), 3); }
-
-// 0xCBDB: SET 3, E (- - - -)
-void op_set_3_e(GameBoy *gb) { REG(E) = set_bit(REG(E), 3); }
-
-// 0xCBDC: SET 3, H (- - - -)
-void op_set_3_h(GameBoy *gb) { REG(H) = set_bit(REG(H), 3); }
-
-// 0xCBDD: SET 3, L (- - - -)
-void op_set_3_l(GameBoy *gb) { REG(L) = set_bit(REG(L), 3); }
-
-// 0xCBDE: SET 3, (HL) (- - - -)
-void op_set_3_hlp(GameBoy *gb) {
-    const uint8_t hl = READ8(REG(HL));
-    TICK(1);
-    WRITE8(REG(HL), set_bit(hl, 3));
-    TICK(1);
-}
-
-// 0xCBDF: SET 3, A (- - - -)
-void op_set_3_a(GameBoy *gb) { REG(A) = set_bit(REG(A), 3); }
-
-// 0xCBE0: SET 4, B (- - - -)
-void op_set_4_b(GameBoy *gb) { REG(B) = set_bit(REG(B), 4); }
-
-// 0xCBE1: SET 4, C (- - - -)
-void op_set_4_c(GameBoy *gb) { REG(C) = set_bit(REG(C), 4); }
-
-// 0xCBE2: SET 4, D (- - - -)
-void op_set_4_d(GameBoy *gb) { REG(D) = set_bit(REG(D), 4); }
-
-// 0xCBE3: SET 4, E (- - - -)
-void op_set_4_e(GameBoy *gb) { REG(E) = set_bit(REG(E), 4); }
-
-// 0xCBE4: SET 4, H (- - - -)
-void op_set_4_h(GameBoy *gb) { REG(H) = set_bit(REG(H), 4); }
-
-// 0xCBE5: SET 4, L (- - - -)
-void op_set_4_l(GameBoy *gb) { REG(L) = set_bit(REG(L), 4); }
-
-// 0xCBE6: SET 4, (HL) (- - - -)
-void op_set_4_hlp(GameBoy *gb) {
-    const uint8_t hl = READ8(REG(HL));
-    TICK(1);
-    WRITE8(REG(HL), set_bit(hl, 4));
-    TICK(1);
-}
-
-// 0xCBE7: SET 4, A (- - - -)
-void op_set_4_a(GameBoy *gb) { REG(A) = set_bit(REG(A), 4); }
-
-// 0xCBE8: SET 5, B (- - - -)
-void op_set_5_b(GameBoy *gb) { REG(B) = set_bit(REG(B), 5); }
-
-// 0xCBE9: SET 5, C (- - - -)
-void op_set_5_c(GameBoy *gb) { REG(C) = set_bit(REG(C), 5); }
-
-// 0xCBEA: SET 5, D (- - - -)
-void op_set_5_d(GameBoy *gb) { REG(D) = set_bit(REG(D), 5); }
-
-// 0xCBEB: SET 5, E (- - - -)
-void op_set_5_e(GameBoy *gb) { REG(E) = set_bit(REG(E), 5); }
-
-// 0xCBEC: SET 5, H (- - - -)
-void op_set_5_h(GameBoy *gb) { REG(H) = set_bit(REG(H), 5); }
-
-// 0xCBED: SET 5, L (- - - -)
-void op_set_5_l(GameBoy *gb) { REG(L) = set_bit(REG(L), 5); }
-
-// 0xCBEE: SET 5, (HL) (- - - -)
-void op_set_5_hlp(GameBoy *gb) {
-    const uint8_t hl = READ8(REG(HL));
-    TICK(1);
-    WRITE8(REG(HL), set_bit(hl, 5));
-    TICK(1);
-}
-
-// 0xCBEF: SET 5, A (- - - -)
-void op_set_5_a(GameBoy *gb) { REG(A) = set_bit(REG(A), 5); }
-
-// 0xCBF0: SET 6, B (- - - -)
-void op_set_6_b(GameBoy *gb) { REG(B) = set_bit(REG(B), 6); }
-
-// 0xCBF1: SET 6, C (- - - -)
-void op_set_6_c(GameBoy *gb) { REG(C) = set_bit(REG(C), 6); }
-
-// 0xCBF2: SET 6, D (- - - -)
-void op_set_6_d(GameBoy *gb) { REG(D) = set_bit(REG(D), 6); }
-
-// 0xCBF3: SET 6, E (- - - -)
-void op_set_6_e(GameBoy *gb) { REG(E) = set_bit(REG(E), 6); }
-
-// 0xCBF4: SET 6, H (- - - -)
-void op_set_6_h(GameBoy *gb) { REG(H) = set_bit(REG(H), 6); }
-
-// 0xCBF5: SET 6, L (- - - -)
-void op_set_6_l(GameBoy *gb) { REG(L) = set_bit(REG(L), 6); }
-
-// 0xCBF6: SET 6, (HL) (- - - -)
-void op_set_6_hlp(GameBoy *gb) {
-    const uint8_t hl = READ8(REG(HL));
-    TICK(1);
-    WRITE8(REG(HL), set_bit(hl, 6));
-    TICK(1);
+/*
+    CB prefixed instructions
+    The opcode encodes the operation in bits 3 to 7 and the operand in bits 0 to 2
+*/
+
+// Operand order of the low 3 bits, (HL) is read from memory instead
+static uint8_t *cb_register(GameBoy *gb, const uint8_t index) {
+    static const uint8_t offsets[8] = {
+        offsetof(Registers, B), offsetof(Registers, C), offsetof(Registers, D), offsetof(Registers, E),
+        offsetof(Registers, H), offsetof(Registers, L), 0,                      offsetof(Registers, A),
+    };
+
+    return (uint8_t *) &gb->cpu.reg + offsets[index];
+}
+
+// 0xCB00 - 0xCB3F: RLC, RRC, RL, RR, SLA, SRA, SWAP and SRL, in the order of bits 3 to 5
+static uint8_t rotate_shift(GameBoy *gb, const uint8_t operation, const uint8_t value) {
+    switch (operation) {
+    case 0:
+        return rotate_left_carry(gb, value, true);
+    case 1:
+        return rotate_right_carry(gb, value, true);
+    case 2:
+        return rotate_left(gb, value, true);
+    case 3:
+        return rotate_right(gb, value);
+    case 4:
+        return shift_left_arith(gb, value);
+    case 5:
+        return shift_right_arith(gb, value);
+    case 6:
+        return swap(gb, value);
+    default:
+        return shift_right_logic(gb, value);
+    }
 }
 
-// 0xCBF7: SET 6, A (- - - -)
-void op_set_6_a(GameBoy *gb) { REG(A) = set_bit(REG(A), 6); }
-
-// 0xCBF8: SET 7, B (- - - -)
-void op_set_7_b(GameBoy *gb) { REG(B) = set_bit(REG(B), 7); }
+// The (HL) forms take a cycle for the read and another for the write, BIT only reads
+void execute_cb(GameBoy *gb, const uint8_t opcode) {
+    const uint8_t operand = opcode & 0x7;
+    const uint8_t index = (opcode >> 3) & 0x7;
+    const bool is_memory = operand == CB_OPERAND_HL;
 
-// 0xCBF9: SET 7, C (- - - -)
-void op_set_7_c(GameBoy *gb) { REG(C) = set_bit(REG(C), 7); }
+    uint8_t *reg = is_memory ? NULL : cb_register(gb, operand);
+    uint8_t value;
 
-// 0xCBFA: SET 7, D (- - - -)
-void op_set_7_d(GameBoy *gb) { REG(D) = set_bit(REG(D), 7); }
-
-// 0xCBFB: SET 7, E (- - - -)
-void op_set_7_e(GameBoy *gb) { REG(E) = set_bit(REG(E), 7); }
-
-// 0xCBFC: SET 7, H (- - - -)
-void op_set_7_h(GameBoy *gb) { REG(H) = set_bit(REG(H), 7); }
+    if (is_memory) {
+        value = READ8(REG(HL));
+        TICK(1);
+    } else {
+        value = *reg;
+    }
 
-// 0xCBFD: SET 7, L (- - - -)
-void op_set_7_l(GameBoy *gb) { REG(L) = set_bit(REG(L), 7); }
+    switch (opcode >> 6) {
+    // 0xCB00 - 0xCB3F: Rotates, shifts and SWAP
+    case 0:
+        value = rotate_shift(gb, index, value);
+        break;
+
+    // 0xCB40 - 0xCB7F: BIT n, r (Z 0 1 -)
+    case 1:
+        test_bit(gb, value, index);
+        return;
+
+    // 0xCB80 - 0xCBBF: RES n, r (- - - -)
+    case 2:
+        value = reset_bit(value, index);
+        break;
+
+    // 0xCBC0 - 0xCBFF: SET n, r (- - - -)
+    default:
+        value = set_bit(value, index);
+        break;
+    }
 
-// 0xCBFE: SET 7, (HL) (- - - -)
-void op_set_7_hlp(GameBoy *gb) {
-    const uint8_t hl = READ8(REG(HL));
-    TICK(1);
-    WRITE8(REG(HL), set_bit(hl, 7));
-    TICK(1);
+    if (is_memory) {
+        WRITE8(REG(HL), value);
+        TICK(1);
+    } else {
+        *reg = value;
+    }
 }
-
-// 0xCBFF: SET 7, A (- - - -)
-void op_set_7_a(GameBoy *gb) { REG(A) = set_bit(REG(A), 7); }
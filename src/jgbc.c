@@ -9,18 +9,30 @@
 #include "jgbc.h"
 
 #include "apu.h"
+#include "arena.h"
 #include "cart.h"
 #include "cpu.h"
-#include "input.h"
+#include "frontend.h"
 #include "mmu.h"
 #include "ppu.h"
+#include "recomp.h"
 
 static void handle_event(GameBoy *, SDL_Event);
-static void set_window_title(GameBoy *);
-static void run(GameBoy *);
+static void init_window(GameBoy *, Frontend *);
+static void render_frame(void *, const uint16_t *);
+static void set_window_title(GameBoy *, Frontend *);
+static void run(GameBoy *, Frontend *, uint32_t);
+static SaveWriter *start_save_writer(GameBoy *);
+static void flush_save_writer(GameBoy *, SaveWriter *);
+static void stop_save_writer(SaveWriter *);
+static int run_save_writer(void *);
+static void run_benchmark(GameBoy *);
+static bool run_stress(const char *, uint32_t);
+static int run_stress_instance(void *);
 static void take_screenshot(GameBoy *);
 static void print_help();
-static void serial_write_handler(uint8_t);
+static void print_stats(GameBoy *);
+static void serial_write_handler(void *, uint8_t);
 static CliArgs parse_cli_args(int, const char **);
 
 
@@ -44,7 +56,15 @@ int main(const int argc, const char **argv) {
         return EXIT_FAILURE;
     }
 
-    SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO);
+    // The instances only need threads and the clock, which work without initialising SDL
+    if (args.stress_instances > 0) {
+        return run_stress(args.rom_path, args.stress_instances) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // Without a window there is no audio either, the events still deliver the quit signal
+    const bool has_output = !args.is_headless && !args.should_benchmark;
+    SDL_Init(has_output ? SDL_INIT_VIDEO | SDL_INIT_AUDIO : SDL_INIT_EVENTS);
+
     GameBoy *gb = malloc(sizeof(GameBoy));
     init(gb);
 
@@ -57,9 +77,20 @@ int main(const int argc, const char **argv) {
         fprintf(stderr, "ERROR: Cannot load ram (save) file\n");
     }
 
-    if (!args.is_headless) {
-        init_window(gb);
-        set_window_title(gb);
+    if (args.should_load_recompiled && !load_recompiled(gb)) {
+        fprintf(stderr, "ERROR: Cannot load recompiled rom %s%s, falling back to the interpreter\n", gb->cart.image->filename,
+                RECOMP_EXTENSION);
+    }
+
+    Frontend frontend = {0};
+
+    if (has_output) {
+        init_window(gb, &frontend);
+        set_window_title(gb, &frontend);
+
+        if (open_audio(gb, &frontend.audio_device) == 0) {
+            fprintf(stderr, "ERROR: Cannot open audio device: %s\n", SDL_GetError());
+        }
     }
 
     if (args.should_print_serial) {
@@ -70,54 +101,280 @@ int main(const int argc, const char **argv) {
         print_cart_info(gb);
     }
 
-    SDL_PauseAudioDevice(gb->apu.device_id, 0);
-    run(gb);
+    if (args.should_benchmark) {
+        run_benchmark(gb);
+    } else {
+        // The emulation runs silently when the device could not be opened
+        if (frontend.audio_device != 0) {
+            SDL_PauseAudioDevice(frontend.audio_device, 0);
+        }
+
+        run(gb, &frontend, args.save_interval);
+    }
+
+    if (args.should_print_stats) {
+        print_stats(gb);
+    }
 
     SDL_Quit();
     return EXIT_SUCCESS;
 }
 
-static void run(GameBoy *gb) {
+static void run(GameBoy *gb, Frontend *frontend, const uint32_t save_interval) {
     SDL_Event event;
     gb->is_running = true;
 
+    const uint64_t frame_ticks = (uint64_t) (SDL_GetPerformanceFrequency() / FRAMERATE);
+    uint64_t next_frame = SDL_GetPerformanceCounter();
+
+    // Without a writer the ram is only saved on exit
+    SaveWriter *writer = save_interval > 0 && gb->cart.image->ram_size > 0 ? start_save_writer(gb) : NULL;
+    const uint64_t save_ticks = SDL_GetPerformanceFrequency() * save_interval;
+    uint64_t next_save = SDL_GetPerformanceCounter() + save_ticks;
+
     while (gb->is_running) {
-        static const uint32_t max_ticks = CLOCK_SPEED / FRAMERATE;
-        uint32_t frame_ticks = 0;
+        run_frame(gb);
 
-        while (frame_ticks < max_ticks) {
-            update_cpu(gb);
+        // Paced by the audio device, by the clock when there is none
+        if (frontend->audio_device != 0) {
+            while (SDL_GetQueuedAudioSize(frontend->audio_device)) {
+                SDL_Delay(1);
+            }
+        } else {
+            next_frame += frame_ticks;
 
-            if (gb->cpu.is_double_speed) {
-                check_interrupts(gb);
-                update_cpu(gb);
+            while (SDL_GetPerformanceCounter() < next_frame) {
+                SDL_Delay(1);
             }
+        }
 
-            update_ppu(gb);
-            check_interrupts(gb);
-            update_apu(gb);
-            update_dma(gb);
-            update_hdma(gb);
+        while (SDL_PollEvent(&event)) {
+            handle_event(gb, event);
+        }
 
-            frame_ticks += gb->cpu.ticks;
+        if (writer != NULL && SDL_GetPerformanceCounter() >= next_save) {
+            flush_save_writer(gb, writer);
+            next_save = SDL_GetPerformanceCounter() + save_ticks;
         }
+    }
+
+    if (writer != NULL) {
+        stop_save_writer(writer);
+    }
+
+    save_ram(gb);
+}
+
+static SaveWriter *start_save_writer(GameBoy *gb) {
+    SaveWriter *writer = calloc(1, sizeof(SaveWriter));
+    snprintf(writer->filename, sizeof(writer->filename), "%s%s", gb->cart.image->filename, SAVE_EXTENSION);
+
+    writer->lock = SDL_CreateMutex();
+    writer->has_banks = SDL_CreateCond();
+    writer->is_running = true;
+    writer->thread = SDL_CreateThread(run_save_writer, "jgbc_save", writer);
 
-        while (SDL_GetQueuedAudioSize(gb->apu.device_id)) {
-            SDL_Delay(1);
+    if (writer->thread == NULL) {
+        SDL_DestroyCond(writer->has_banks);
+        SDL_DestroyMutex(writer->lock);
+        free(writer);
+        return NULL;
+    }
+
+    return writer;
+}
+
+// Copies the changed banks for the writer, skipped while it is still writing the previous ones
+// The banks stay dirty in the instance until a flush takes them
+static void flush_save_writer(GameBoy *gb, SaveWriter *writer) {
+    if (SDL_TryLockMutex(writer->lock) != 0) {
+        return;
+    }
+
+    const uint16_t dirty_banks = take_dirty_ram(gb);
+
+    for (uint8_t i = 0; i < EXTRAM_BANK_COUNT; ++i) {
+        if (dirty_banks & (1 << i)) {
+            memcpy(writer->banks[i], gb->cart.ram_banks[i], EXTRAM_BANK_SIZE);
         }
+    }
 
-        while (SDL_PollEvent(&event)) {
-            handle_event(gb, event);
+    writer->dirty_banks |= dirty_banks;
+    SDL_CondSignal(writer->has_banks);
+    SDL_UnlockMutex(writer->lock);
+}
+
+// Writes whatever the thread has not written yet, the instance saves its newer banks after this
+static void stop_save_writer(SaveWriter *writer) {
+    SDL_LockMutex(writer->lock);
+    writer->is_running = false;
+    SDL_CondSignal(writer->has_banks);
+    SDL_UnlockMutex(writer->lock);
+
+    SDL_WaitThread(writer->thread, NULL);
+
+    uint8_t *banks[EXTRAM_BANK_COUNT];
+
+    for (uint8_t i = 0; i < EXTRAM_BANK_COUNT; ++i) {
+        banks[i] = writer->banks[i];
+    }
+
+    write_ram_banks(writer->filename, banks, writer->dirty_banks);
+
+    SDL_DestroyCond(writer->has_banks);
+    SDL_DestroyMutex(writer->lock);
+    free(writer);
+}
+
+// The copies are written with the lock held, a flush arriving meanwhile is skipped instead of waiting
+static int run_save_writer(void *data) {
+    SaveWriter *writer = data;
+    uint8_t *banks[EXTRAM_BANK_COUNT];
+
+    for (uint8_t i = 0; i < EXTRAM_BANK_COUNT; ++i) {
+        banks[i] = writer->banks[i];
+    }
+
+    SDL_LockMutex(writer->lock);
+
+    while (writer->is_running) {
+        SDL_CondWait(writer->has_banks, writer->lock);
+
+        // Failed banks are tried again with the next flush
+        if (write_ram_banks(writer->filename, banks, writer->dirty_banks)) {
+            writer->dirty_banks = 0;
         }
     }
 
-    save_ram(gb);
+    SDL_UnlockMutex(writer->lock);
+    return 0;
+}
+
+// Runs a fixed number of frames as fast as possible
+static void run_benchmark(GameBoy *gb) {
+    const uint64_t start = SDL_GetPerformanceCounter();
+
+    for (uint32_t i = 0; i < BENCHMARK_FRAMES; ++i) {
+        run_frame(gb);
+    }
+
+    const double seconds = (double) (SDL_GetPerformanceCounter() - start) / (double) SDL_GetPerformanceFrequency();
+
+    printf("Ran %d frames in %.3fs\n", BENCHMARK_FRAMES, seconds);
+    printf("Frames per second: %.1f (%.1fx real time)\n", BENCHMARK_FRAMES / seconds,
+           BENCHMARK_FRAMES / seconds / FRAMERATE);
+    printf("Instructions per second: %.0f\n", (double) gb->stats.instructions / seconds);
+}
+
+typedef struct {
+    GameBoy *gb;
+    uint64_t hash;
+} StressInstance;
+
+// Runs instances of the rom on their own threads, then the same number again one after the other
+// They all start from the same state, any difference means they share something they should not
+static bool run_stress(const char *path, const uint32_t count) {
+    CartImage *image = load_cart_image(path);
+
+    if (image == NULL) {
+        fprintf(stderr, "ERROR: Cannot load rom file\n");
+        return false;
+    }
+
+    StressInstance *parallel = calloc(count, sizeof(StressInstance));
+    StressInstance *serial = calloc(count, sizeof(StressInstance));
+    SDL_Thread **threads = malloc(count * sizeof(SDL_Thread *));
+
+    for (uint32_t i = 0; i < count; ++i) {
+        parallel[i].gb = malloc(sizeof(GameBoy));
+        init(parallel[i].gb);
+        attach_cart(parallel[i].gb, image);
+
+        serial[i].gb = malloc(sizeof(GameBoy));
+        init(serial[i].gb);
+        attach_cart(serial[i].gb, image);
+    }
+
+    release_cart_image(image);
+    const uint64_t start = SDL_GetPerformanceCounter();
+
+    for (uint32_t i = 0; i < count; ++i) {
+        threads[i] = SDL_CreateThread(run_stress_instance, "jgbc_stress", &parallel[i]);
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        SDL_WaitThread(threads[i], NULL);
+    }
+
+    const uint64_t middle = SDL_GetPerformanceCounter();
+
+    for (uint32_t i = 0; i < count; ++i) {
+        run_stress_instance(&serial[i]);
+    }
+
+    const uint64_t end = SDL_GetPerformanceCounter();
+    const double frequency = (double) SDL_GetPerformanceFrequency();
+    bool is_identical = true;
+
+    for (uint32_t i = 0; i < count; ++i) {
+        if (parallel[i].hash != serial[i].hash || parallel[i].hash != serial[0].hash) {
+            fprintf(stderr, "ERROR: Instance %u ended in state %016llX instead of %016llX\n", i,
+                    (unsigned long long) parallel[i].hash, (unsigned long long) serial[i].hash);
+            is_identical = false;
+        }
+
+        detach_cart(parallel[i].gb);
+        destroy(parallel[i].gb);
+        free(parallel[i].gb);
+
+        detach_cart(serial[i].gb);
+        destroy(serial[i].gb);
+        free(serial[i].gb);
+    }
+
+    printf("Ran %u instances for %d frames: %.3fs in parallel, %.3fs one after the other\n", count, STRESS_FRAMES,
+           (double) (middle - start) / frequency, (double) (end - middle) / frequency);
+    printf("%s\n", is_identical ? "Every instance ended in the same state" : "The instances diverged");
+
+    free(threads);
+    free(serial);
+    free(parallel);
+    return is_identical;
+}
+
+// FNV-1a of every frame, the registers and the memory at the end
+static int run_stress_instance(void *data) {
+    StressInstance *instance = data;
+    GameBoy *gb = instance->gb;
+    uint64_t hash = 0xCBF29CE484222325;
+
+    for (uint32_t i = 0; i < STRESS_FRAMES; ++i) {
+        run_frame(gb);
+
+        for (size_t j = 0; j < SCREEN_WIDTH * SCREEN_HEIGHT; ++j) {
+            hash ^= gb->ppu.framebuffer[j];
+            hash *= 0x100000001B3;
+        }
+    }
+
+    const uint8_t *state[] = {(const uint8_t *) &gb->cpu.reg, (const uint8_t *) gb->arena};
+    const size_t sizes[] = {sizeof(gb->cpu.reg), sizeof(Arena)};
+
+    for (size_t i = 0; i < 2; ++i) {
+        for (size_t j = 0; j < sizes[i]; ++j) {
+            hash ^= state[i][j];
+            hash *= 0x100000001B3;
+        }
+    }
+
+    instance->hash = hash;
+    return 0;
 }
 
 static void take_screenshot(GameBoy *gb) {
-    const size_t name_len = strlen(gb->cart.title) + 10 + strlen("-.png") + 1;
+    const size_t name_len = strlen(gb->cart.image->title) + 10 + strlen("-.png") + 1;
     char name[name_len];
-    snprintf(name, name_len, "%s-%d.png", gb->cart.title, (int) time(NULL));
+    snprintf(name, name_len, "%s-%d.png", gb->cart.image->title, (int) time(NULL));
 
     uint8_t *image_data = malloc(sizeof(uint8_t) * SCREEN_WIDTH * SCREEN_HEIGHT * 3);
 
@@ -172,13 +429,69 @@ static void print_help() {
     printf("--serial: Output serial to terminal.\n");
     printf("--headless: Don't open a window.\n");
     printf("--info: Print cartridge info.\n");
+    printf("--stats: Print emulation statistics on exit.\n");
+    printf("--benchmark: Run %d frames unthrottled and print the emulation speed.\n", BENCHMARK_FRAMES);
+    printf("--recomp: Run the native code built by jgbc_recomp for this rom.\n");
+    printf("--save-interval=<seconds>: Write the changed cart ram every interval, 0 only on exit (default %d).\n",
+           SAVE_INTERVAL);
+    printf("--stress=<count>: Run the rom on count threads, %d frames each, and check they match a serial run.\n",
+           STRESS_FRAMES);
     printf("--help: Show this help.\n");
 }
 
-static void set_window_title(GameBoy *gb) {
+static void print_skipped_cycles(const char *name, const uint64_t skipped, const uint64_t cycles) {
+    printf("%s skipped cycles: %llu (%.1f%%)\n", name, (unsigned long long) skipped,
+           cycles > 0 ? (double) skipped / (double) cycles * 100.0 : 0.0);
+}
+
+static void print_stats(GameBoy *gb) {
+    const uint64_t cycles = gb->scheduler.cycles;
+
+    printf("Emulated cycles: %llu\n", (unsigned long long) cycles);
+    printf("Instructions: %llu\n", (unsigned long long) gb->stats.instructions);
+    printf("Cached block instructions: %llu\n", (unsigned long long) gb->stats.block_instructions);
+    print_skipped_cycles("Halt", gb->stats.halt_skipped_cycles, cycles);
+    print_skipped_cycles("Idle loop", gb->stats.idle_skipped_cycles, cycles);
+}
+
+static void init_window(GameBoy *gb, Frontend *frontend) {
+    frontend->window = SDL_CreateWindow(WINDOW_TITLE, SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
+                                        SCREEN_WIDTH * SCREEN_INITIAL_SCALE, SCREEN_HEIGHT * SCREEN_INITIAL_SCALE,
+                                        SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE);
+
+    frontend->renderer =
+        SDL_CreateRenderer(frontend->window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+
+    SDL_RenderSetLogicalSize(frontend->renderer, SCREEN_WIDTH, SCREEN_HEIGHT);
+    SDL_SetWindowMinimumSize(frontend->window, SCREEN_WIDTH, SCREEN_HEIGHT);
+
+    SDL_DisplayMode mode;
+    mode.refresh_rate = FRAMERATE;
+    SDL_SetWindowDisplayMode(frontend->window, &mode);
+
+    frontend->texture = SDL_CreateTexture(frontend->renderer, SDL_PIXELFORMAT_ABGR1555, SDL_TEXTUREACCESS_STREAMING,
+                                          SCREEN_WIDTH, SCREEN_HEIGHT);
+
+    gb->ppu.frame_handler = render_frame;
+    gb->ppu.frame_user_data = frontend;
+}
+
+static void render_frame(void *user_data, const uint16_t *framebuffer) {
+    const Frontend *frontend = user_data;
+
+    SDL_SetRenderDrawColor(frontend->renderer, 0, 0, 0, 255);
+    SDL_RenderClear(frontend->renderer);
+
+    SDL_UpdateTexture(frontend->texture, NULL, framebuffer, SCREEN_WIDTH * sizeof(uint16_t));
+
+    SDL_RenderCopy(frontend->renderer, frontend->texture, NULL, NULL);
+    SDL_RenderPresent(frontend->renderer);
+}
+
+static void set_window_title(GameBoy *gb, Frontend *frontend) {
     char buffer[30];
-    snprintf(buffer, 30, "%s - %s", WINDOW_TITLE, gb->cart.title);
-    SDL_SetWindowTitle(gb->ppu.window, buffer);
+    snprintf(buffer, 30, "%s - %s", WINDOW_TITLE, gb->cart.image->title);
+    SDL_SetWindowTitle(frontend->window, buffer);
 }
 
 static CliArgs parse_cli_args(const int argc, const char **argv) {
@@ -189,6 +502,11 @@ static CliArgs parse_cli_args(const int argc, const char **argv) {
     result.should_print_serial = false;
     result.should_show_help = false;
     result.should_print_info = false;
+    result.should_print_stats = false;
+    result.should_benchmark = false;
+    result.should_load_recompiled = false;
+    result.stress_instances = 0;
+    result.save_interval = SAVE_INTERVAL;
 
     if (argc < 1) {
         return result;
@@ -206,6 +524,25 @@ static CliArgs parse_cli_args(const int argc, const char **argv) {
                 result.is_headless = true;
             } else if (strcmp(option, "info") == 0) {
                 result.should_print_info = true;
+            } else if (strcmp(option, "benchmark") == 0) {
+                result.should_benchmark = true;
+            } else if (strcmp(option, "stats") == 0) {
+                result.should_print_stats = true;
+            } else if (strcmp(option, "recomp") == 0) {
+                result.should_load_recompiled = true;
+            } else if (strncmp(option, "stress=", strlen("stress=")) == 0) {
+                result.stress_instances = strtoul(option + strlen("stress="), NULL, 10);
+
+                if (result.stress_instances == 0) {
+                    result.invalid_option_index = i;
+                }
+            } else if (strncmp(option, "save-interval=", strlen("save-interval=")) == 0) {
+                char *end;
+                result.save_interval = strtoul(option + strlen("save-interval="), &end, 10);
+
+                if (*end != '\0') {
+                    result.invalid_option_index = i;
+                }
             } else if (strcmp(option, "help") == 0) {
                 result.should_show_help = true;
             } else {
@@ -227,4 +564,4 @@ static CliArgs parse_cli_args(const int argc, const char **argv) {
     return result;
 }
 
-static void serial_write_handler(const uint8_t data) { printf("%c", data); }
+static void serial_write_handler(void *user_data, const uint8_t data) { printf("%c", data); }
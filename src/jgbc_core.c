@@ -0,0 +1,98 @@
+#include "jgbc_core.h"
+#include "apu.h"
+#include "arena.h"
+#include "cart.h"
+#include "input.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Holds a few buffers of the APU until the caller takes them, the oldest samples are dropped past that
+#define AUDIO_QUEUE_SIZE (AUDIO_BUFFER_SIZE * 4)
+
+typedef struct {
+    float samples[AUDIO_QUEUE_SIZE];
+    size_t count;
+} AudioQueue;
+
+static void queue_samples(void *, const float *, size_t);
+
+GameBoy *jgbc_create(void) {
+    GameBoy *gb = calloc(1, sizeof(GameBoy));
+    init(gb);
+
+    gb->apu.audio_handler = queue_samples;
+    gb->apu.audio_user_data = calloc(1, sizeof(AudioQueue));
+    return gb;
+}
+
+// Writes the save back before the cart is released
+void jgbc_destroy(GameBoy *gb) {
+    if (gb->cart.image != NULL) {
+        save_ram(gb);
+        detach_cart(gb);
+    }
+
+    free(gb->apu.audio_user_data);
+    destroy(gb);
+    free(gb);
+}
+
+// Replaces the cart, the machine starts over from the state of a new instance
+bool jgbc_load_rom(GameBoy *gb, const char *path) {
+    if (gb->cart.image != NULL) {
+        save_ram(gb);
+        detach_cart(gb);
+    }
+
+    // Reset leaves the memory as it was
+    memset(gb->arena, 0, sizeof(Arena));
+    reset(gb);
+    ((AudioQueue *) gb->apu.audio_user_data)->count = 0;
+
+    if (!load_rom(gb, path)) {
+        return false;
+    }
+
+    // A missing save leaves the ram blank
+    load_ram(gb);
+    return true;
+}
+
+void jgbc_run_frame(GameBoy *gb) { run_frame(gb); }
+
+const uint16_t *jgbc_framebuffer(GameBoy *gb) { return gb->ppu.framebuffer; }
+
+// Moves up to count of the queued samples to the buffer, returns how many were moved
+size_t jgbc_audio_samples(GameBoy *gb, float *samples, size_t count) {
+    AudioQueue *queue = gb->apu.audio_user_data;
+
+    if (count > queue->count) {
+        count = queue->count;
+    }
+
+    memcpy(samples, queue->samples, count * sizeof(float));
+    memmove(queue->samples, queue->samples + count, (queue->count - count) * sizeof(float));
+    queue->count -= count;
+
+    return count;
+}
+
+void jgbc_set_input(GameBoy *gb, const uint8_t buttons) {
+    for (uint8_t i = ButtonA; i <= ButtonDown; ++i) {
+        set_button(gb, i, (buttons >> i) & 1);
+    }
+}
+
+static void queue_samples(void *user_data, const float *samples, const size_t count) {
+    AudioQueue *queue = user_data;
+
+    if (queue->count + count > AUDIO_QUEUE_SIZE) {
+        const size_t dropped = queue->count + count - AUDIO_QUEUE_SIZE;
+
+        memmove(queue->samples, queue->samples + dropped, (queue->count - dropped) * sizeof(float));
+        queue->count -= dropped;
+    }
+
+    memcpy(queue->samples + queue->count, samples, count * sizeof(float));
+    queue->count += count;
+}
@@ -0,0 +1,738 @@
+#include "jit.h"
+
+#ifdef JIT
+
+#include "alu.h"
+#include "cpu.h"
+#include "macro.h"
+#include "mmu.h"
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/mman.h>
+
+// Longest machine code of one instruction: the bookkeeping of emit_begin and emit_end is about 200 bytes,
+// a load through (HL) adds about 210 more for its inline access and the call on the slow path
+#define JIT_MAX_INSTRUCTION_SIZE 512
+
+// Longest machine code of a block, the prologue and epilogue take 6 bytes
+#define JIT_MAX_BLOCK_SIZE (BLOCK_MAX_LENGTH * JIT_MAX_INSTRUCTION_SIZE + 64)
+
+// Offsets of the state accessed by the generated code, relative to the GameBoy held in rbx
+#define OFFSET(member) ((int32_t) offsetof(GameBoy, member))
+
+// x86-64 condition codes
+#define COND_B 0x2
+#define COND_AE 0x3
+#define COND_E 0x4
+#define COND_NE 0x5
+#define COND_A 0x7
+
+// Work RAM and high RAM relative to the start of work RAM, covered by the inline memory accesses
+#define FAST_WRAM00_END 0x1000
+#define FAST_WRAM_END 0x2000
+#define FAST_HRAM_START (HRAM_START - WRAM00_START)
+#define FAST_HRAM_END (HRAM_END + 1 - WRAM00_START)
+
+typedef struct {
+    uint8_t *code;
+    uint32_t size;
+} Emitter;
+
+static void emit8(Emitter *, uint8_t);
+static void emit16(Emitter *, uint16_t);
+static void emit32(Emitter *, uint32_t);
+static void emit64(Emitter *, uint64_t);
+static void emit_gb_operand(Emitter *, uint8_t, uint8_t, int32_t);
+static uint32_t emit_jump(Emitter *, int8_t);
+static void patch_jump(Emitter *, uint32_t);
+static void emit_call(Emitter *, const void *);
+static void emit_tick(Emitter *, uint32_t);
+static void emit_begin(Emitter *, const BlockInstruction *, uint16_t);
+static bool emit_native(Emitter *, const BlockInstruction *, uint16_t);
+static bool emit_memory_access(Emitter *, const BlockInstruction *, bool, int32_t);
+static bool emit_alu(Emitter *, const BlockInstruction *, uint16_t);
+static bool emit_branch(Emitter *, const BlockInstruction *, uint16_t);
+static uint32_t emit_condition(Emitter *, uint8_t);
+static void emit_fetch(Emitter *, const BlockInstruction *, uint16_t);
+static void emit_end(Emitter *, uint16_t, uint8_t, bool, uint32_t *, uint8_t *);
+static int32_t register_offset(uint8_t);
+
+void init_jit(GameBoy *gb) {
+    void *buffer = mmap(NULL, JIT_BUFFER_SIZE, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    // Blocks keep running in the interpreter without executable memory
+    gb->block_cache.code_buffer = buffer == MAP_FAILED ? NULL : buffer;
+    gb->block_cache.code_used = 0;
+}
+
+void free_jit(GameBoy *gb) {
+    if (gb->block_cache.code_buffer != NULL) {
+        munmap(gb->block_cache.code_buffer, JIT_BUFFER_SIZE);
+        gb->block_cache.code_buffer = NULL;
+    }
+}
+
+// Translates a block to a function taking the GameBoy, it runs until the deadline of the scheduler
+// Every instruction does the same bookkeeping as the interpreter so the emulation stays cycle accurate
+// Simple loads, ALU operations and jumps are inlined, other instructions call their handler
+bool compile_jit(GameBoy *gb, Block *block) {
+    if (gb->block_cache.code_buffer == NULL) {
+        return false;
+    }
+
+    // Start over when full, dropping the machine code of every block compiled here
+    if (gb->block_cache.code_used + JIT_MAX_BLOCK_SIZE > JIT_BUFFER_SIZE) {
+        const uint8_t *buffer = gb->block_cache.code_buffer;
+
+        for (uint16_t i = 0; i < BLOCK_CACHE_SIZE; ++i) {
+            const uint8_t *code = (const uint8_t *) gb->block_cache.blocks[i].code;
+
+            // Counting from zero again, the block gets compiled once it is hot again
+            if (code >= buffer && code < buffer + JIT_BUFFER_SIZE) {
+                gb->block_cache.blocks[i].code = NULL;
+                gb->block_cache.blocks[i].hits = 0;
+            }
+        }
+
+        gb->block_cache.code_used = 0;
+    }
+
+    Emitter e = {gb->block_cache.code_buffer + gb->block_cache.code_used, 0};
+    uint32_t exits[BLOCK_MAX_LENGTH * 4];
+    uint8_t exit_count = 0;
+
+    // push rbx; mov rbx, rdi
+    emit8(&e, 0x53);
+    emit8(&e, 0x48);
+    emit8(&e, 0x89);
+    emit8(&e, 0xFB);
+
+    uint16_t address = block->address;
+
+    for (uint8_t i = 0; i < block->length; ++i) {
+        const BlockInstruction *instr = &block->instructions[i];
+        const bool is_last = i + 1 == block->length;
+        const uint32_t start = e.size;
+
+        emit_begin(&e, instr, address);
+
+        if (!emit_native(&e, instr, address)) {
+            // mov rdi, rbx
+            emit8(&e, 0x48);
+            emit8(&e, 0x89);
+            emit8(&e, 0xDF);
+            emit_call(&e, instr->handler);
+        }
+
+        emit_end(&e, address, instr->length, is_last, exits, &exit_count);
+        address += instr->length;
+
+        // The room left in the buffer was only checked against the bound
+        assert(e.size - start <= JIT_MAX_INSTRUCTION_SIZE);
+    }
+
+    for (uint8_t i = 0; i < exit_count; ++i) {
+        patch_jump(&e, exits[i]);
+    }
+
+    // pop rbx; ret
+    emit8(&e, 0x5B);
+    emit8(&e, 0xC3);
+
+    block->code = (BlockCode) e.code;
+    gb->block_cache.code_used += e.size;
+
+    return true;
+}
+
+static void emit8(Emitter *e, const uint8_t value) { e->code[e->size++] = value; }
+
+static void emit16(Emitter *e, const uint16_t value) {
+    memcpy(e->code + e->size, &value, sizeof(value));
+    e->size += sizeof(value);
+}
+
+static void emit32(Emitter *e, const uint32_t value) {
+    memcpy(e->code + e->size, &value, sizeof(value));
+    e->size += sizeof(value);
+}
+
+static void emit64(Emitter *e, const uint64_t value) {
+    memcpy(e->code + e->size, &value, sizeof(value));
+    e->size += sizeof(value);
+}
+
+// Opcode followed by a [rbx + offset] memory operand
+static void emit_gb_operand(Emitter *e, const uint8_t opcode, const uint8_t reg, const int32_t offset) {
+    emit8(e, opcode);
+    emit8(e, 0x80 | (reg << 3) | 0x3);
+    emit32(e, (uint32_t) offset);
+}
+
+// Jump with a 32 bit displacement patched later, unconditional when cond is negative
+static uint32_t emit_jump(Emitter *e, const int8_t cond) {
+    if (cond < 0) {
+        emit8(e, 0xE9);
+    } else {
+        emit8(e, 0x0F);
+        emit8(e, 0x80 | cond);
+    }
+
+    emit32(e, 0);
+    return e->size;
+}
+
+// Points the jump ending at position to the current end of the code
+static void patch_jump(Emitter *e, const uint32_t position) {
+    const uint32_t displacement = e->size - position;
+    memcpy(e->code + position - 4, &displacement, sizeof(displacement));
+}
+
+// mov rax, function; call rax
+static void emit_call(Emitter *e, const void *function) {
+    emit8(e, 0x48);
+    emit8(e, 0xB8);
+    emit64(e, (uint64_t) (uintptr_t) function);
+    emit8(e, 0xFF);
+    emit8(e, 0xD0);
+}
+
+// Same as tick_timer, update_timer is only called when the timer needs it
+static void emit_tick(Emitter *e, const uint32_t ticks) {
+    // mov rax, [clock]; add rax, ticks; mov [clock], rax; cmp rax, [next_update]
+    emit8(e, 0x48);
+    emit_gb_operand(e, 0x8B, 0, OFFSET(cpu.timer.clock));
+    emit8(e, 0x48);
+    emit8(e, 0x83);
+    emit8(e, 0xC0);
+    emit8(e, ticks);
+    emit8(e, 0x48);
+    emit_gb_operand(e, 0x89, 0, OFFSET(cpu.timer.clock));
+    emit8(e, 0x48);
+    emit_gb_operand(e, 0x3B, 0, OFFSET(cpu.timer.next_update));
+
+    const uint32_t skip = emit_jump(e, COND_B);
+
+    // mov rdi, rbx
+    emit8(e, 0x48);
+    emit8(e, 0x89);
+    emit8(e, 0xDF);
+    emit_call(e, update_timer);
+
+    patch_jump(e, skip);
+}
+
+// The opcode has been fetched, PC is known while the block runs
+static void emit_begin(Emitter *e, const BlockInstruction *instr, const uint16_t address) {
+    // mov dword [ticks], CPU_STEP
+    emit_gb_operand(e, 0xC7, 0, OFFSET(cpu.ticks));
+    emit32(e, CPU_STEP);
+
+    emit_tick(e, CPU_STEP);
+
+    // mov word [PC], address + 1
+    emit8(e, 0x66);
+    emit_gb_operand(e, 0xC7, 0, OFFSET(cpu.reg.PC));
+    emit16(e, address + 1);
+
+    if (instr->length > 1) {
+        // mov word [decoded_operand], operand
+        emit8(e, 0x66);
+        emit_gb_operand(e, 0xC7, 0, OFFSET(cpu.decoded_operand));
+        emit16(e, instr->operand);
+    }
+}
+
+// Machine code for loads, ALU operations and jumps, false when the handler has to be called
+static bool emit_native(Emitter *e, const BlockInstruction *instr, const uint16_t address) {
+    const uint8_t opcode = instr->opcode;
+
+    // NOP
+    if (opcode == 0x00) {
+        return true;
+    }
+
+    // LD r, d8: mov byte [r], d8
+    if ((opcode & 0xC7) == 0x06 && opcode != 0x36) {
+        emit_gb_operand(e, 0xC6, 0, register_offset((opcode >> 3) & 0x7));
+        emit8(e, instr->operand);
+        emit_fetch(e, instr, address);
+        return true;
+    }
+
+    if ((opcode >= 0x80 && opcode <= 0xBF) || (opcode & 0xC7) == 0xC6) {
+        return emit_alu(e, instr, address);
+    }
+
+    if (opcode == 0x18 || opcode == 0xC3 || (opcode & 0xE7) == 0x20 || (opcode & 0xE7) == 0xC2) {
+        return emit_branch(e, instr, address);
+    }
+
+    if (opcode < 0x40 || opcode > 0x7F || opcode == 0x76) {
+        return false;
+    }
+
+    const uint8_t dest = (opcode >> 3) & 0x7;
+    const uint8_t src = opcode & 0x7;
+
+    // LD r, (HL)
+    if (src == 0x6) {
+        return emit_memory_access(e, instr, false, register_offset(dest));
+    }
+
+    // LD (HL), r
+    if (dest == 0x6) {
+        return emit_memory_access(e, instr, true, register_offset(src));
+    }
+
+    // LD r, r: mov al, [src]; mov [dest], al
+    emit_gb_operand(e, 0x8A, 0, register_offset(src));
+    emit_gb_operand(e, 0x88, 0, register_offset(dest));
+    return true;
+}
+
+// Accesses work RAM and high RAM directly, the handler deals with any other address
+// Writes over cached code also go through the handler so the blocks get flushed
+static bool emit_memory_access(Emitter *e, const BlockInstruction *instr, const bool is_write, const int32_t reg) {
+    uint32_t slow[4];
+
+    // movzx ecx, word [HL]; sub ecx, WRAM00_START
+    emit8(e, 0x0F);
+    emit_gb_operand(e, 0xB7, 1, OFFSET(cpu.reg.HL));
+    emit8(e, 0x81);
+    emit8(e, 0xE9);
+    emit32(e, WRAM00_START);
+
+    // cmp ecx, FAST_WRAM_END; jb in_range
+    emit8(e, 0x81);
+    emit8(e, 0xF9);
+    emit32(e, FAST_WRAM_END);
+    const uint32_t in_range = emit_jump(e, COND_B);
+
+    // cmp ecx, FAST_HRAM_START; jb slow; cmp ecx, FAST_HRAM_END; jae slow
+    emit8(e, 0x81);
+    emit8(e, 0xF9);
+    emit32(e, FAST_HRAM_START);
+    slow[0] = emit_jump(e, COND_B);
+    emit8(e, 0x81);
+    emit8(e, 0xF9);
+    emit32(e, FAST_HRAM_END);
+    slow[1] = emit_jump(e, COND_AE);
+
+    patch_jump(e, in_range);
+    uint8_t slow_count = 2;
+
+    if (is_write) {
+        // mov rdx, [code_map]; bt dword [rdx], ecx; jc slow
+        emit8(e, 0x48);
+        emit_gb_operand(e, 0x8B, 2, OFFSET(block_cache.code_map));
+        emit8(e, 0x0F);
+        emit8(e, 0xA3);
+        emit8(e, 0x0A);
+        slow[slow_count++] = emit_jump(e, COND_B);
+    }
+
+    // cmp ecx, FAST_WRAM00_END; jae wramNN; mov rdx, [wram00]; jmp access
+    emit8(e, 0x81);
+    emit8(e, 0xF9);
+    emit32(e, FAST_WRAM00_END);
+    const uint32_t wramNN = emit_jump(e, COND_AE);
+    emit8(e, 0x48);
+    emit_gb_operand(e, 0x8B, 2, OFFSET(mmu.wram00));
+    const uint32_t wram00_access = emit_jump(e, -1);
+
+    // wramNN: cmp ecx, FAST_WRAM_END; jae hram; sub ecx, FAST_WRAM00_END; mov rdx, [wramNN]; jmp access
+    patch_jump(e, wramNN);
+    emit8(e, 0x81);
+    emit8(e, 0xF9);
+    emit32(e, FAST_WRAM_END);
+    const uint32_t hram = emit_jump(e, COND_AE);
+    emit8(e, 0x81);
+    emit8(e, 0xE9);
+    emit32(e, FAST_WRAM00_END);
+    emit8(e, 0x48);
+    emit_gb_operand(e, 0x8B, 2, OFFSET(mmu.wramNN));
+    const uint32_t wramNN_access = emit_jump(e, -1);
+
+    // hram: sub ecx, FAST_HRAM_START; mov rdx, [hram]
+    patch_jump(e, hram);
+    emit8(e, 0x81);
+    emit8(e, 0xE9);
+    emit32(e, FAST_HRAM_START);
+    emit8(e, 0x48);
+    emit_gb_operand(e, 0x8B, 2, OFFSET(mmu.hram));
+
+    patch_jump(e, wram00_access);
+    patch_jump(e, wramNN_access);
+
+    if (is_write) {
+        // mov al, [r]; mov [rdx + rcx], al
+        emit_gb_operand(e, 0x8A, 0, reg);
+        emit8(e, 0x88);
+        emit8(e, 0x04);
+        emit8(e, 0x0A);
+    } else {
+        // mov al, [rdx + rcx]; mov [r], al
+        emit8(e, 0x8A);
+        emit8(e, 0x04);
+        emit8(e, 0x0A);
+        emit_gb_operand(e, 0x88, 0, reg);
+    }
+
+    // add dword [ticks], CPU_STEP
+    emit_gb_operand(e, 0x83, 0, OFFSET(cpu.ticks));
+    emit8(e, CPU_STEP);
+    emit_tick(e, CPU_STEP);
+    const uint32_t done = emit_jump(e, -1);
+
+    // slow: mov rdi, rbx; call handler
+    for (uint8_t i = 0; i < slow_count; ++i) {
+        patch_jump(e, slow[i]);
+    }
+
+    emit8(e, 0x48);
+    emit8(e, 0x89);
+    emit8(e, 0xDF);
+    emit_call(e, instr->handler);
+
+    patch_jump(e, done);
+    return true;
+}
+
+// ADD, SUB, AND, XOR, OR and CP with a register or d8, the flags are deferred the same way as in alu.c
+// ADC and SBC need the pending carry and (HL) a memory access, both are left to the handler
+static bool emit_alu(Emitter *e, const BlockInstruction *instr, const uint16_t address) {
+    const uint8_t operation = (instr->opcode >> 3) & 0x7;
+    const uint8_t src = instr->opcode & 0x7;
+    const bool is_immediate = instr->opcode >= 0xC0;
+    FlagOp op;
+    uint8_t alu_opcode;
+
+#ifdef VERIFY_LAZY_FLAGS
+    // The flags are only checked in defer_flags
+    return false;
+#endif
+
+    switch (operation) {
+    case 0:
+        op = FlagsAdd;
+        alu_opcode = 0x00;
+        break;
+    case 2:
+    case 7:
+        op = FlagsSub;
+        alu_opcode = 0x28;
+        break;
+    case 4:
+        op = FlagsAnd;
+        alu_opcode = 0x20;
+        break;
+    case 5:
+        op = FlagsOr;
+        alu_opcode = 0x30;
+        break;
+    case 6:
+        op = FlagsOr;
+        alu_opcode = 0x08;
+        break;
+    default:
+        return false;
+    }
+
+    if (!is_immediate && src == 0x6) {
+        return false;
+    }
+
+    if (is_immediate) {
+        emit_fetch(e, instr, address);
+    }
+
+    // movzx eax, byte [A]
+    emit8(e, 0x0F);
+    emit_gb_operand(e, 0xB6, 0, OFFSET(cpu.reg.A));
+
+    if (is_immediate) {
+        // mov ecx, d8
+        emit8(e, 0xB9);
+        emit32(e, instr->operand & 0xFF);
+    } else {
+        // movzx ecx, byte [r]
+        emit8(e, 0x0F);
+        emit_gb_operand(e, 0xB6, 1, register_offset(src));
+    }
+
+    if (op == FlagsAdd || op == FlagsSub) {
+        // mov word [flags.a], ax; mov word [flags.b], cx
+        emit8(e, 0x66);
+        emit_gb_operand(e, 0x89, 0, OFFSET(cpu.flags.a));
+        emit8(e, 0x66);
+        emit_gb_operand(e, 0x89, 1, OFFSET(cpu.flags.b));
+    }
+
+    // op al, cl
+    emit8(e, alu_opcode);
+    emit8(e, 0xC8);
+
+    // CP only sets the flags: mov byte [A], al
+    if (operation != 7) {
+        emit_gb_operand(e, 0x88, 0, OFFSET(cpu.reg.A));
+    }
+
+    if (op == FlagsAnd || op == FlagsOr) {
+        // The result is deferred: movzx eax, al; mov word [flags.a], ax; mov word [flags.b], 0
+        emit8(e, 0x0F);
+        emit8(e, 0xB6);
+        emit8(e, 0xC0);
+        emit8(e, 0x66);
+        emit_gb_operand(e, 0x89, 0, OFFSET(cpu.flags.a));
+        emit8(e, 0x66);
+        emit_gb_operand(e, 0xC7, 0, OFFSET(cpu.flags.b));
+        emit16(e, 0);
+    }
+
+    // mov dword [flags.op], op; mov byte [flags.carry], 0; mov byte [flags.kept], 0
+    emit_gb_operand(e, 0xC7, 0, OFFSET(cpu.flags.op));
+    emit32(e, op);
+    emit_gb_operand(e, 0xC6, 0, OFFSET(cpu.flags.carry));
+    emit8(e, 0);
+    emit_gb_operand(e, 0xC6, 0, OFFSET(cpu.flags.kept));
+    emit8(e, 0);
+
+    return true;
+}
+
+// JR and JP, the conditional ones only take the cycle of the jump when it is taken
+static bool emit_branch(Emitter *e, const BlockInstruction *instr, const uint16_t address) {
+    const uint8_t opcode = instr->opcode;
+    const bool is_conditional = opcode != 0x18 && opcode != 0xC3;
+    const uint16_t target = opcode < 0x40 ? address + 2 + (int8_t) instr->operand : instr->operand;
+    uint32_t not_taken = 0;
+
+    emit_fetch(e, instr, address);
+
+    if (is_conditional) {
+        not_taken = emit_condition(e, (opcode >> 3) & 0x3);
+    }
+
+    // mov word [PC], target; add dword [ticks], CPU_STEP
+    emit8(e, 0x66);
+    emit_gb_operand(e, 0xC7, 0, OFFSET(cpu.reg.PC));
+    emit16(e, target);
+    emit_gb_operand(e, 0x83, 0, OFFSET(cpu.ticks));
+    emit8(e, CPU_STEP);
+    emit_tick(e, CPU_STEP);
+
+    if (is_conditional) {
+        patch_jump(e, not_taken);
+    }
+
+    return true;
+}
+
+// Tests NZ, Z, NC or C, the returned jump is taken when the condition does not hold
+// Z and C of logic operations and subtractions come from the deferred operands, other operations evaluate F
+static uint32_t emit_condition(Emitter *e, const uint8_t condition) {
+    const bool is_carry = condition >= 2;
+    uint32_t slow[2];
+    uint32_t decided[2];
+
+    // mov eax, [flags.op]; cmp eax, FlagsOr; ja arithmetic; test eax, eax; je evaluated
+    emit_gb_operand(e, 0x8B, 0, OFFSET(cpu.flags.op));
+    emit8(e, 0x83);
+    emit8(e, 0xF8);
+    emit8(e, FlagsOr);
+    const uint32_t arithmetic = emit_jump(e, COND_A);
+    emit8(e, 0x85);
+    emit8(e, 0xC0);
+    const uint32_t evaluated = emit_jump(e, COND_E);
+
+    // AND, OR and XOR keep their result in a and clear the carry
+    if (is_carry) {
+        // xor edx, edx
+        emit8(e, 0x31);
+        emit8(e, 0xD2);
+    } else {
+        // cmp word [flags.a], 0; sete dl
+        emit8(e, 0x66);
+        emit_gb_operand(e, 0x83, 7, OFFSET(cpu.flags.a));
+        emit8(e, 0);
+        emit8(e, 0x0F);
+        emit8(e, 0x94);
+        emit8(e, 0xC2);
+    }
+
+    decided[0] = emit_jump(e, -1);
+
+    // arithmetic: cmp eax, FlagsSub; jb slow; cmp eax, FlagsSubCarry; ja slow
+    patch_jump(e, arithmetic);
+    emit8(e, 0x83);
+    emit8(e, 0xF8);
+    emit8(e, FlagsSub);
+    slow[0] = emit_jump(e, COND_B);
+    emit8(e, 0x83);
+    emit8(e, 0xF8);
+    emit8(e, FlagsSubCarry);
+    slow[1] = emit_jump(e, COND_A);
+
+    // movzx eax, word [flags.a]; movzx ecx, word [flags.b]; movzx edx, byte [flags.carry]
+    emit8(e, 0x0F);
+    emit_gb_operand(e, 0xB7, 0, OFFSET(cpu.flags.a));
+    emit8(e, 0x0F);
+    emit_gb_operand(e, 0xB7, 1, OFFSET(cpu.flags.b));
+    emit8(e, 0x0F);
+    emit_gb_operand(e, 0xB6, 2, OFFSET(cpu.flags.carry));
+
+    if (is_carry) {
+        // a < b + carry: add ecx, edx; cmp eax, ecx; setb dl
+        emit8(e, 0x01);
+        emit8(e, 0xD1);
+        emit8(e, 0x39);
+        emit8(e, 0xC8);
+        emit8(e, 0x0F);
+        emit8(e, 0x92);
+        emit8(e, 0xC2);
+    } else {
+        // (uint8_t) (a - b - carry) == 0: sub eax, ecx; sub eax, edx; test al, al; sete dl
+        emit8(e, 0x29);
+        emit8(e, 0xC8);
+        emit8(e, 0x29);
+        emit8(e, 0xD0);
+        emit8(e, 0x84);
+        emit8(e, 0xC0);
+        emit8(e, 0x0F);
+        emit8(e, 0x94);
+        emit8(e, 0xC2);
+    }
+
+    decided[1] = emit_jump(e, -1);
+
+    // slow: mov rdi, rbx; call evaluate_flags
+    patch_jump(e, slow[0]);
+    patch_jump(e, slow[1]);
+    emit8(e, 0x48);
+    emit8(e, 0x89);
+    emit8(e, 0xDF);
+    emit_call(e, evaluate_flags);
+
+    // evaluated: test byte [F], flag; setne dl
+    patch_jump(e, evaluated);
+    emit_gb_operand(e, 0xF6, 0, OFFSET(cpu.reg.F));
+    emit8(e, 1 << (is_carry ? FLAG_CARRY : FLAG_ZERO));
+    emit8(e, 0x0F);
+    emit8(e, 0x95);
+    emit8(e, 0xC2);
+
+    patch_jump(e, decided[0]);
+    patch_jump(e, decided[1]);
+
+    // test dl, dl, NZ and NC hold when the flag is clear
+    emit8(e, 0x84);
+    emit8(e, 0xD2);
+    return emit_jump(e, condition & 1 ? COND_E : COND_NE);
+}
+
+// Moves PC past the operand and takes the cycles of reading it, like fetch_byte and fetch_short
+static void emit_fetch(Emitter *e, const BlockInstruction *instr, const uint16_t address) {
+    const uint8_t ticks = (instr->length - 1) * CPU_STEP;
+
+    // mov word [PC], address + length; add dword [ticks], ticks
+    emit8(e, 0x66);
+    emit_gb_operand(e, 0xC7, 0, OFFSET(cpu.reg.PC));
+    emit16(e, address + instr->length);
+    emit_gb_operand(e, 0x83, 0, OFFSET(cpu.ticks));
+    emit8(e, ticks);
+    emit_tick(e, ticks);
+}
+
+// Same as the end of an instruction in the interpreter, leaves the block unless the next instruction runs
+static void emit_end(Emitter *e, const uint16_t address, const uint8_t length, const bool is_last,
+                     uint32_t *exits, uint8_t *exit_count) {
+    // add qword [instructions], 1; add qword [block_instructions], 1
+    emit8(e, 0x48);
+    emit_gb_operand(e, 0x83, 0, OFFSET(stats.instructions));
+    emit8(e, 1);
+    emit8(e, 0x48);
+    emit_gb_operand(e, 0x83, 0, OFFSET(stats.block_instructions));
+    emit8(e, 1);
+
+    // Branches end blocks, mov rdi, rbx; mov esi, address; call check_idle_branch
+    if (is_last) {
+        emit8(e, 0x48);
+        emit8(e, 0x89);
+        emit8(e, 0xDF);
+        emit8(e, 0xBE);
+        emit32(e, address);
+        emit_call(e, check_idle_branch);
+    }
+
+    // mov eax, [ticks]; movzx ecx, byte [is_double_speed]; shr eax, cl; add [cycles], rax
+    emit_gb_operand(e, 0x8B, 0, OFFSET(cpu.ticks));
+    emit8(e, 0x0F);
+    emit_gb_operand(e, 0xB6, 1, OFFSET(cpu.is_double_speed));
+    emit8(e, 0xD3);
+    emit8(e, 0xE8);
+    emit8(e, 0x48);
+    emit_gb_operand(e, 0x01, 0, OFFSET(scheduler.cycles));
+
+    // cmp byte [pending_interrupts], 0; je skip; mov rdi, rbx; call check_interrupts
+    emit_gb_operand(e, 0x80, 7, OFFSET(cpu.pending_interrupts));
+    emit8(e, 0);
+    const uint32_t skip = emit_jump(e, COND_E);
+    emit8(e, 0x48);
+    emit8(e, 0x89);
+    emit8(e, 0xDF);
+    emit_call(e, check_interrupts);
+    patch_jump(e, skip);
+
+    if (is_last) {
+        return;
+    }
+
+    // cmp word [PC], address + length; jne exit
+    emit8(e, 0x66);
+    emit_gb_operand(e, 0x81, 7, OFFSET(cpu.reg.PC));
+    emit16(e, address + length);
+    exits[(*exit_count)++] = emit_jump(e, COND_NE);
+
+    // The handlers can schedule events, read the deadline again
+    // mov rax, [deadline]; cmp [cycles], rax; jae exit
+    emit8(e, 0x48);
+    emit_gb_operand(e, 0x8B, 0, OFFSET(scheduler.deadline));
+    emit8(e, 0x48);
+    emit_gb_operand(e, 0x39, 0, OFFSET(scheduler.cycles));
+    exits[(*exit_count)++] = emit_jump(e, COND_AE);
+
+    // cmp byte [is_halted], 0; jne exit; cmp byte [is_stale], 0; jne exit
+    emit_gb_operand(e, 0x80, 7, OFFSET(cpu.is_halted));
+    emit8(e, 0);
+    exits[(*exit_count)++] = emit_jump(e, COND_NE);
+    emit_gb_operand(e, 0x80, 7, OFFSET(block_cache.is_stale));
+    emit8(e, 0);
+    exits[(*exit_count)++] = emit_jump(e, COND_NE);
+}
+
+// Register operand of the 8 bit loads, (HL) is handled separately
+static int32_t register_offset(const uint8_t index) {
+    switch (index) {
+    case 0:
+        return OFFSET(cpu.reg.B);
+    case 1:
+        return OFFSET(cpu.reg.C);
+    case 2:
+        return OFFSET(cpu.reg.D);
+    case 3:
+        return OFFSET(cpu.reg.E);
+    case 4:
+        return OFFSET(cpu.reg.H);
+    case 5:
+        return OFFSET(cpu.reg.L);
+    case 7:
+        return OFFSET(cpu.reg.A);
+    default:
+        ASSERT_NOT_REACHED();
+        return 0;
+    }
+}
+
+#endif
@@ -1,89 +1,266 @@
 #include "mbc.h"
+#include "cpu.h"
+#include "mmu.h"
+#include "macro.h"
+#include <string.h>
 
-void mbc1_handler(GameBoy *gb, const uint16_t address, const uint8_t value) {
-    static MBC1Mode mode = RomBanking;
-    static bool ram_enabled = false;
+static void mbc1_write(GameBoy *, uint16_t, uint8_t);
+static void mbc2_write(GameBoy *, uint16_t, uint8_t);
+static uint8_t mbc2_read_ram(GameBoy *, uint16_t);
+static void mbc2_write_ram(GameBoy *, uint16_t, uint8_t);
+static void mbc3_write(GameBoy *, uint16_t, uint8_t);
+static uint8_t mbc3_read_ram(GameBoy *, uint16_t);
+static void mbc3_write_ram(GameBoy *, uint16_t, uint8_t);
+static void mbc5_write(GameBoy *, uint16_t, uint8_t);
+static void sync_rtc(GameBoy *);
+static void latch_rtc(GameBoy *);
 
-    uint16_t rom_bank = gb->mmu.rom_bank;
-    uint8_t ram_bank = gb->mmu.ram_bank;
+const MBCType mbc1 = {mbc1_write, NULL, NULL};
+const MBCType mbc2 = {mbc2_write, mbc2_read_ram, mbc2_write_ram};
+const MBCType mbc3 = {mbc3_write, mbc3_read_ram, mbc3_write_ram};
+const MBCType mbc5 = {mbc5_write, NULL, NULL};
 
-    if (address <= MBC1_RAM_ENABLE_END) {
-        ram_enabled = (value & 0xF) == MBC1_RAM_ENABLE_NIBBLE ? true : false;
-    // Select the lower 5 bits of the rom bank
-    } else if (address >= MBC1_ROM_CHANGE_START && address <= MBC1_ROM_CHANGE_END) {
-        uint8_t lower = value & MBC1_ROM_CHANGE;
+static inline void switch_rom00(GameBoy *gb, const uint16_t bank) {
+    gb->mmu.rom00_bank = bank & gb->cart.mbc.rom_mask;
+    gb->mmu.rom00 = gb->cart.image->rom_banks[gb->mmu.rom00_bank];
+}
+
+static inline void switch_romNN(GameBoy *gb, const uint16_t bank) {
+    gb->mmu.rom_bank = bank & gb->cart.mbc.rom_mask;
+    gb->mmu.romNN = gb->cart.image->rom_banks[gb->mmu.rom_bank];
+}
 
-        // Banks 0x0, 0x20, 0x40, and 0x60 are unselectable
-        if (lower == 0) {
-            lower++;
+// The ram is only mapped while enabled, reads give 0xFF otherwise
+static inline void switch_ram(GameBoy *gb, const uint8_t bank) {
+    if (gb->cart.mbc.ram_enabled && gb->cart.image->ram_size > 0) {
+        gb->mmu.ram_bank = bank & gb->cart.mbc.ram_mask;
+        gb->mmu.extram = gb->cart.ram_banks[gb->mmu.ram_bank];
+    } else {
+        gb->mmu.ram_bank = -1;
+        gb->mmu.extram = NULL;
+    }
+}
+
+// Power on state, the MMU maps the banks chosen here
+void reset_mbc(GameBoy *gb) {
+    const CartImage *image = gb->cart.image;
+    MBC *mbc = &gb->cart.mbc;
+
+    memset(mbc, 0, sizeof(MBC));
+    mbc->rom_bank = 1;
+    mbc->rom_mask = image->rom_size - 1;
+    mbc->ram_mask = image->ram_size > 0 ? image->ram_size - 1 : 0;
+    mbc->rtc.start = gb->scheduler.cycles;
+
+    gb->mmu.mbc = image->mbc;
+    switch_rom00(gb, 0);
+    switch_romNN(gb, 1);
+    switch_ram(gb, 0);
+    update_pages(gb);
+}
+
+static void mbc1_write(GameBoy *gb, const uint16_t address, const uint8_t value) {
+    MBC *mbc = &gb->cart.mbc;
+
+    if (address <= MBC_RAM_ENABLE_END) {
+        mbc->ram_enabled = (value & 0xF) == MBC_RAM_ENABLE_NIBBLE;
+        switch_ram(gb, mbc->mode ? mbc->ram_bank : 0);
+    }
+    // Lower 5 bits of the rom bank, banks 0x0, 0x20, 0x40 and 0x60 are unselectable
+    else if (address <= MBC1_ROM_CHANGE_END) {
+        mbc->rom_bank = (value & MBC1_ROM_CHANGE) != 0 ? value & MBC1_ROM_CHANGE : 1;
+        switch_romNN(gb, mbc->ram_bank << MBC1_ROM_RAM_CHANGE_SHIFT | mbc->rom_bank);
+    }
+    // Upper 2 bits of the rom bank, in ram banking mode also the ram bank and the first rom bank
+    else if (address <= MBC1_ROM_RAM_CHANGE_END) {
+        mbc->ram_bank = value & MBC1_ROM_RAM_CHANGE;
+        switch_romNN(gb, mbc->ram_bank << MBC1_ROM_RAM_CHANGE_SHIFT | mbc->rom_bank);
+
+        if (mbc->mode) {
+            switch_rom00(gb, mbc->ram_bank << MBC1_ROM_RAM_CHANGE_SHIFT);
+            switch_ram(gb, mbc->ram_bank);
         }
+    } else {
+        mbc->mode = value & 0x1;
+        switch_rom00(gb, mbc->mode ? mbc->ram_bank << MBC1_ROM_RAM_CHANGE_SHIFT : 0);
+        switch_ram(gb, mbc->mode ? mbc->ram_bank : 0);
+    }
+}
 
-        rom_bank = (rom_bank & ~MBC1_ROM_CHANGE) | lower;
+static void mbc2_write(GameBoy *gb, const uint16_t address, const uint8_t value) {
+    MBC *mbc = &gb->cart.mbc;
+
+    if (address > MBC2_REGISTER_END) {
+        return;
     }
-    // Select the upper 2 bits of the rom or ram bank (5 and 6) (not bit 7)
-    else if (address >= MBC1_ROM_RAM_CHANGE_START && address <= MBC1_ROM_RAM_CHANGE_END) {
-        rom_bank = (rom_bank & ~MBC1_ROM_RAM_CHANGE) | ((value & 0x3) << 5);
-        ram_bank = value;
-    } else if (address >= MBC1_MODE_CHANGE_START && address <= MBC1_MODE_CHANGE_END) {
-        mode = value;
+
+    if (address & MBC2_ROM_SELECT) {
+        mbc->rom_bank = (value & MBC2_ROM_CHANGE) != 0 ? value & MBC2_ROM_CHANGE : 1;
+        switch_romNN(gb, mbc->rom_bank);
+    } else {
+        mbc->ram_enabled = (value & 0xF) == MBC_RAM_ENABLE_NIBBLE;
     }
+}
 
-    // Only ram bank 0 can be used in rom mode
-    if (mode == RomBanking) {
-        gb->mmu.rom00 = gb->cart.rom_banks[0];
-        ram_bank = 0;
+// The built in ram stores half bytes, the upper bits read as ones
+static uint8_t mbc2_read_ram(GameBoy *gb, const uint16_t address) {
+    if (!gb->cart.mbc.ram_enabled) {
+        return 0xFF;
     }
-    // Only rom banks 0-1F can be used in ram mode
-    else if (mode == RamBanking) {
-        uint8_t eff_rom_bank = rom_bank & MBC1_ROM_RAM_CHANGE;
-        eff_rom_bank %= gb->cart.rom_size;
-        gb->mmu.rom00 = gb->cart.rom_banks[eff_rom_bank];
 
-        rom_bank &= MBC1_ROM_CHANGE;
+    return 0xF0 | gb->cart.ram_banks[0][address % MBC2_RAM_SIZE];
+}
+
+static void mbc2_write_ram(GameBoy *gb, const uint16_t address, const uint8_t value) {
+    if (gb->cart.mbc.ram_enabled) {
+        gb->cart.ram_banks[0][address % MBC2_RAM_SIZE] = value & 0xF;
+        gb->cart.dirty_banks |= 1;
     }
+}
 
-    gb->mmu.rom_bank = rom_bank % gb->cart.rom_size;
-    gb->mmu.romNN = gb->cart.rom_banks[gb->mmu.rom_bank];
+static void mbc3_write(GameBoy *gb, const uint16_t address, const uint8_t value) {
+    MBC *mbc = &gb->cart.mbc;
 
-    if (ram_enabled && gb->cart.ram_size > 0) {
-        gb->mmu.ram_bank = ram_bank % gb->cart.ram_size;
-        gb->mmu.extram = gb->cart.ram_banks[gb->mmu.ram_bank];
+    if (address <= MBC_RAM_ENABLE_END) {
+        mbc->ram_enabled = (value & 0xF) == MBC_RAM_ENABLE_NIBBLE;
+    } else if (address <= MBC3_ROM_CHANGE_END) {
+        mbc->rom_bank = (value & MBC3_ROM_CHANGE) != 0 ? value & MBC3_ROM_CHANGE : 1;
+        switch_romNN(gb, mbc->rom_bank);
+        return;
+    } else if (address <= MBC3_RAM_CHANGE_END) {
+        mbc->ram_bank = value;
     } else {
+        // Writing 0 then 1 copies the clock to the registers the program reads
+        if (mbc->rtc.latch == 0 && value == 1) {
+            latch_rtc(gb);
+        }
+
+        mbc->rtc.latch = value;
+        return;
+    }
+
+    // The clock registers are read through the MBC
+    if (mbc->ram_bank >= RTC_S) {
         gb->mmu.ram_bank = -1;
         gb->mmu.extram = NULL;
+    } else {
+        switch_ram(gb, mbc->ram_bank);
+    }
+}
+
+static uint8_t mbc3_read_ram(GameBoy *gb, const uint16_t address) {
+    const MBC *mbc = &gb->cart.mbc;
+
+    if (!mbc->ram_enabled || mbc->ram_bank < RTC_S || mbc->ram_bank > RTC_DH) {
+        return 0xFF;
     }
+
+    return mbc->rtc.latched[mbc->ram_bank - RTC_S];
 }
 
-void mbc2_handler(GameBoy *gb, const uint16_t address, const uint8_t value) { mbc1_handler(gb, address, value); }
+// Writes set the running clock, the latched registers are left as they are
+static void mbc3_write_ram(GameBoy *gb, const uint16_t address, const uint8_t value) {
+    MBC *mbc = &gb->cart.mbc;
+    RTC *rtc = &mbc->rtc;
+
+    if (!mbc->ram_enabled || mbc->ram_bank < RTC_S || mbc->ram_bank > RTC_DH) {
+        return;
+    }
+
+    sync_rtc(gb);
+
+    uint64_t seconds = rtc->seconds % 60;
+    uint64_t minutes = rtc->seconds / 60 % 60;
+    uint64_t hours = rtc->seconds / 3600 % 24;
+    uint64_t days = rtc->seconds / RTC_SECONDS_PER_DAY;
 
-void mbc3_handler(GameBoy *gb, const uint16_t address, const uint8_t value) { mbc1_handler(gb, address, value); }
+    switch (mbc->ram_bank) {
+    case RTC_S:
+        seconds = value & 0x3F;
+        rtc->start = gb->scheduler.cycles; // Starts a new second
+        break;
 
-void mbc4_handler(GameBoy *gb, const uint16_t address, const uint8_t value) { mbc1_handler(gb, address, value); }
+    case RTC_M:
+        minutes = value & 0x3F;
+        break;
 
-void mbc5_handler(GameBoy *gb, const uint16_t address, const uint8_t value) {
-    static bool ram_enabled = false;
+    case RTC_H:
+        hours = value & 0x1F;
+        break;
 
-    uint16_t rom_bank = gb->mmu.rom_bank;
-    uint8_t ram_bank = gb->mmu.ram_bank;
+    case RTC_DL:
+        days = (days & 0x100) | value;
+        break;
 
-    if (address <= MBC1_RAM_ENABLE_END) {
-        ram_enabled = (value & 0xF) == MBC1_RAM_ENABLE_NIBBLE ? true : false;
-    } else if (address >= MBC5_ROM_CHANGE_LOW_START && address <= MBC5_ROM_CHANGE_LOW_END)
-        rom_bank = (rom_bank & 0x100) | value; // keep the top bit
-    else if (address >= MBC5_ROM_CHANGE_HIGH_START && address <= MBC5_ROM_CHANGE_HIGH_END) {
-        rom_bank = (rom_bank & 0xFF) | ((value & 0x1) << 8);
-    } else if (address >= MBC5_RAM_CHANGE_START && address <= MBC5_RAM_CHANGE_END) {
-        ram_bank = value & 0xF;
+    case RTC_DH:
+        days = (days & 0xFF) | (GET_BIT(value, RTC_DH_DAY_HIGH) << 8);
+        rtc->has_carry = GET_BIT(value, RTC_DH_CARRY);
+
+        if (!rtc->is_halted && GET_BIT(value, RTC_DH_HALT)) {
+            rtc->is_halted = true;
+        } else if (rtc->is_halted && !GET_BIT(value, RTC_DH_HALT)) {
+            rtc->is_halted = false;
+            rtc->start = gb->scheduler.cycles;
+        }
+        break;
     }
 
-    gb->mmu.rom_bank = rom_bank % gb->cart.rom_size;
-    gb->mmu.romNN = gb->cart.rom_banks[gb->mmu.rom_bank];
+    rtc->seconds = ((days * 24 + hours) * 60 + minutes) * 60 + seconds;
+}
 
-    if (ram_enabled && gb->cart.ram_size > 0) {
-        gb->mmu.ram_bank = ram_bank % gb->cart.ram_size;
-        gb->mmu.extram = gb->cart.ram_banks[gb->mmu.ram_bank];
-    } else {
-        gb->mmu.ram_bank = -1;
-        gb->mmu.extram = NULL;
+static void mbc5_write(GameBoy *gb, const uint16_t address, const uint8_t value) {
+    MBC *mbc = &gb->cart.mbc;
+
+    if (address <= MBC_RAM_ENABLE_END) {
+        mbc->ram_enabled = (value & 0xF) == MBC_RAM_ENABLE_NIBBLE;
+        switch_ram(gb, mbc->ram_bank);
+    }
+    // Unlike the MBC1, bank 0 can be selected here
+    else if (address <= MBC5_ROM_CHANGE_LOW_END) {
+        mbc->rom_bank = (mbc->rom_bank & 0x100) | value;
+        switch_romNN(gb, mbc->rom_bank);
+    } else if (address <= MBC5_ROM_CHANGE_HIGH_END) {
+        mbc->rom_bank = (mbc->rom_bank & 0xFF) | ((value & 0x1) << 8);
+        switch_romNN(gb, mbc->rom_bank);
+    } else if (address <= MBC5_RAM_CHANGE_END) {
+        mbc->ram_bank = value & MBC5_RAM_CHANGE;
+        switch_ram(gb, mbc->ram_bank);
+    }
+}
+
+// The clock is never ticked, the seconds since start are added when it is read or written
+static void sync_rtc(GameBoy *gb) {
+    RTC *rtc = &gb->cart.mbc.rtc;
+
+    // The cycle counter starts over on reset
+    if (gb->scheduler.cycles < rtc->start) {
+        rtc->start = gb->scheduler.cycles;
+    }
+
+    if (!rtc->is_halted) {
+        const uint64_t elapsed = (gb->scheduler.cycles - rtc->start) / CLOCK_SPEED;
+
+        rtc->seconds += elapsed;
+        rtc->start += elapsed * CLOCK_SPEED;
+    }
+
+    // The carry stays set until the program clears it
+    if (rtc->seconds >= (uint64_t)RTC_DAYS * RTC_SECONDS_PER_DAY) {
+        rtc->seconds %= (uint64_t)RTC_DAYS * RTC_SECONDS_PER_DAY;
+        rtc->has_carry = true;
     }
 }
+
+static void latch_rtc(GameBoy *gb) {
+    RTC *rtc = &gb->cart.mbc.rtc;
+    sync_rtc(gb);
+
+    const uint64_t days = rtc->seconds / RTC_SECONDS_PER_DAY;
+
+    rtc->latched[RTC_S - RTC_S] = rtc->seconds % 60;
+    rtc->latched[RTC_M - RTC_S] = rtc->seconds / 60 % 60;
+    rtc->latched[RTC_H - RTC_S] = rtc->seconds / 3600 % 24;
+    rtc->latched[RTC_DL - RTC_S] = days & 0xFF;
+    rtc->latched[RTC_DH - RTC_S] =
+        (days >> 8) << RTC_DH_DAY_HIGH | rtc->is_halted << RTC_DH_HALT | rtc->has_carry << RTC_DH_CARRY;
+}
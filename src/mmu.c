@@ -1,57 +1,205 @@
 #include "mmu.h"
 #include "apu.h"
+#include "arena.h"
+#include "block.h"
 #include "cpu.h"
 #include "input.h"
 #include "macro.h"
 #include "ppu.h"
+#include "scheduler.h"
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 
 static uint8_t *get_memory(GameBoy *, uint16_t *);
+static bool is_mbc_ram(GameBoy *, uint16_t);
 static bool is_accessible(GameBoy *, uint16_t);
+static void map_pages(GameBoy *, uint16_t, uint16_t, uint8_t *, bool);
+static void map_extram(GameBoy *);
 
 static void trigger_dma(GameBoy *gb, const uint8_t value);
 static void hdma_write(GameBoy *, uint16_t, uint8_t);
+static void copy_hdma_block(GameBoy *);
+static void copy_memory(GameBoy *, uint8_t *, uint16_t, uint16_t);
+
+static uint8_t read_io(GameBoy *, uint16_t, bool);
+static void write_io(GameBoy *, uint16_t, uint8_t, bool);
+
+static uint8_t joypad_read(GameBoy *, uint16_t, uint8_t);
+static uint8_t unused_read(GameBoy *, uint16_t, uint8_t);
+static uint8_t timer_read(GameBoy *, uint16_t, uint8_t);
+static uint8_t audio_read(GameBoy *, uint16_t, uint8_t);
+static uint8_t key1_read(GameBoy *, uint16_t, uint8_t);
+static uint8_t hdma5_read(GameBoy *, uint16_t, uint8_t);
+
+static bool serial_write(GameBoy *, uint16_t, uint8_t *);
+static bool timer_write(GameBoy *, uint16_t, uint8_t *);
+static bool audio_write(GameBoy *, uint16_t, uint8_t *);
+static bool lcdc_register_write(GameBoy *, uint16_t, uint8_t *);
+static bool stat_write(GameBoy *, uint16_t, uint8_t *);
+static bool ly_write(GameBoy *, uint16_t, uint8_t *);
+static bool dma_write(GameBoy *, uint16_t, uint8_t *);
+static bool vbk_write(GameBoy *, uint16_t, uint8_t *);
+static bool hdma_register_write(GameBoy *, uint16_t, uint8_t *);
+static bool palette_index_register_write(GameBoy *, uint16_t, uint8_t *);
+static bool palette_data_register_write(GameBoy *, uint16_t, uint8_t *);
+static bool svbk_write(GameBoy *, uint16_t, uint8_t *);
+
+typedef struct {
+    // Called on every read with the stored value, returns the value seen
+    uint8_t (*read)(GameBoy *, uint16_t, uint8_t);
+
+    // Called on program writes only, may change the value and returns false to drop it
+    bool (*write)(GameBoy *, uint16_t, uint8_t *);
+
+    // Unused bits, read back as 1 by the program
+    uint8_t read_mask;
+} IORegister;
+
+#define IO_REGISTER(address) [(address) - IO_START]
+
+static const IORegister io_registers[IO_SIZE] = {
+    IO_REGISTER(JOYP) = {joypad_read, NULL, 0xC0},
+    IO_REGISTER(SB) = {NULL, serial_write, 0x00},
+    IO_REGISTER(SC) = {NULL, NULL, 0x7E},
+    IO_REGISTER(DIV) = {timer_read, timer_write, 0x00},
+    IO_REGISTER(TIMA) = {timer_read, timer_write, 0x00},
+    IO_REGISTER(TMA) = {NULL, timer_write, 0x00},
+    IO_REGISTER(TAC) = {NULL, timer_write, 0xF8},
+    IO_REGISTER(IF) = {NULL, NULL, 0xE0},
+
+    IO_REGISTER(NR10) = {audio_read, audio_write, 0x00},
+    IO_REGISTER(NR11) = {audio_read, audio_write, 0x00},
+    IO_REGISTER(NR12) = {audio_read, audio_write, 0x00},
+    IO_REGISTER(NR13) = {audio_read, audio_write, 0x00},
+    IO_REGISTER(NR14) = {audio_read, audio_write, 0x00},
+    IO_REGISTER(NR20) = {audio_read, audio_write, 0x00},
+    IO_REGISTER(NR21) = {audio_read, audio_write, 0x00},
+    IO_REGISTER(NR22) = {audio_read, audio_write, 0x00},
+    IO_REGISTER(NR23) = {audio_read, audio_write, 0x00},
+    IO_REGISTER(NR24) = {audio_read, audio_write, 0x00},
+    IO_REGISTER(NR30) = {audio_read, audio_write, 0x00},
+    IO_REGISTER(NR31) = {audio_read, audio_write, 0x00},
+    IO_REGISTER(NR32) = {audio_read, audio_write, 0x00},
+    IO_REGISTER(NR33) = {audio_read, audio_write, 0x00},
+    IO_REGISTER(NR34) = {audio_read, audio_write, 0x00},
+    IO_REGISTER(NR40) = {audio_read, audio_write, 0x00},
+    IO_REGISTER(NR41) = {audio_read, audio_write, 0x00},
+    IO_REGISTER(NR42) = {audio_read, audio_write, 0x00},
+    IO_REGISTER(NR43) = {audio_read, audio_write, 0x00},
+    IO_REGISTER(NR44) = {audio_read, audio_write, 0x00},
+    IO_REGISTER(NR50) = {audio_read, audio_write, 0x00},
+    IO_REGISTER(NR51) = {audio_read, audio_write, 0x00},
+    IO_REGISTER(NR52) = {audio_read, audio_write, 0x00},
+
+    // Above the NR registers, all data is set to FF
+    IO_REGISTER(0xFF27) = {unused_read, NULL, 0x00},
+    IO_REGISTER(0xFF28) = {unused_read, NULL, 0x00},
+    IO_REGISTER(0xFF29) = {unused_read, NULL, 0x00},
+    IO_REGISTER(0xFF2A) = {unused_read, NULL, 0x00},
+    IO_REGISTER(0xFF2B) = {unused_read, NULL, 0x00},
+    IO_REGISTER(0xFF2C) = {unused_read, NULL, 0x00},
+    IO_REGISTER(0xFF2D) = {unused_read, NULL, 0x00},
+    IO_REGISTER(0xFF2E) = {unused_read, NULL, 0x00},
+    IO_REGISTER(0xFF2F) = {unused_read, NULL, 0x00},
+
+    IO_REGISTER(LCDC) = {NULL, lcdc_register_write, 0x00},
+    IO_REGISTER(STAT) = {NULL, stat_write, 0x80},
+    IO_REGISTER(LY) = {NULL, ly_write, 0x00},
+    IO_REGISTER(DMA) = {NULL, dma_write, 0x00},
+    IO_REGISTER(KEY1) = {key1_read, NULL, 0x7E},
+    IO_REGISTER(VBK) = {NULL, vbk_write, 0xFE},
+
+    IO_REGISTER(HDMA1) = {NULL, hdma_register_write, 0x00},
+    IO_REGISTER(HDMA2) = {NULL, hdma_register_write, 0x00},
+    IO_REGISTER(HDMA3) = {NULL, hdma_register_write, 0x00},
+    IO_REGISTER(HDMA4) = {NULL, hdma_register_write, 0x00},
+    IO_REGISTER(HDMA5) = {hdma5_read, hdma_register_write, 0x00},
+    IO_REGISTER(RP) = {NULL, NULL, 0x3C},
+
+    IO_REGISTER(BGPI) = {NULL, palette_index_register_write, 0x40},
+    IO_REGISTER(BGPD) = {NULL, palette_data_register_write, 0x00},
+    IO_REGISTER(OBPI) = {NULL, palette_index_register_write, 0x40},
+    IO_REGISTER(OBPD) = {NULL, palette_data_register_write, 0x00},
+    IO_REGISTER(SVBK) = {NULL, svbk_write, 0xF8},
+};
 
 void init_mmu(GameBoy *gb) {
     gb->mmu.rom00 = NULL;
     gb->mmu.romNN = NULL;
     gb->mmu.extram = NULL;
 
-    gb->mmu.vram_banks = malloc(sizeof(uint8_t *) * VRAM_BANK_COUNT);
+    for (uint16_t i = 0; i < MMU_PAGE_COUNT; ++i) {
+        gb->mmu.read_pages[i] = NULL;
+        gb->mmu.write_pages[i] = NULL;
+    }
 
     for (uint8_t i = 0; i < VRAM_BANK_COUNT; ++i) {
-        gb->mmu.vram_banks[i] = calloc(VRAM_BANK_SIZE, sizeof(uint8_t));
+        gb->mmu.vram_banks[i] = gb->arena->vram[i];
     }
 
-    gb->mmu.wram_banks = malloc(sizeof(uint8_t *) * WRAM_BANK_COUNT);
-
     for (uint8_t i = 0; i < WRAM_BANK_COUNT; ++i) {
-        gb->mmu.wram_banks[i] = calloc(WRAM_BANK_SIZE, sizeof(uint8_t));
+        gb->mmu.wram_banks[i] = gb->arena->wram[i];
     }
 
-    gb->mmu.oam = calloc(OAM_SIZE, sizeof(uint8_t));
-    gb->mmu.io = calloc(IO_SIZE, sizeof(uint8_t));
-    gb->mmu.hram = calloc(HRAM_SIZE, sizeof(uint8_t));
-    gb->mmu.ier = calloc(1, sizeof(uint8_t));
+    gb->mmu.oam = gb->arena->oam;
+    gb->mmu.io = gb->arena->io;
+    gb->mmu.hram = gb->arena->hram;
+    gb->mmu.ier = &gb->arena->ier;
 
     gb->mmu.serial_write_handler = NULL;
+    gb->mmu.serial_user_data = NULL;
 }
 
 void reset_mmu(GameBoy *gb) {
     gb->mmu.vram = gb->mmu.vram_banks[0];
     gb->mmu.wram00 = gb->mmu.wram_banks[0];
     gb->mmu.wramNN = gb->mmu.wram_banks[1];
+    gb->mmu.vram_bank = 0;
+    gb->mmu.wram_bank = 1;
 
     gb->mmu.dma.is_active = false;
     gb->mmu.dma.address = 0;
-    gb->mmu.dma.clock = 0;
 
     gb->mmu.hdma.is_active = false;
     gb->mmu.hdma.source_addr = 0;
     gb->mmu.hdma.dest_addr = 0;
     gb->mmu.hdma.mode = GeneralPurposeDMA;
     gb->mmu.hdma.length = 0;
+
+    update_pages(gb);
+}
+
+// Rebuilds the page tables after any of the banked regions moved
+// OAM, IO, HRAM and the unusable region always take the slow path
+void update_pages(GameBoy *gb) {
+    // Writes to the rom go to the MBC
+    map_pages(gb, ROM00_START, ROM00_END, gb->mmu.rom00, false);
+    map_pages(gb, ROMNN_START, ROMNN_END, gb->mmu.romNN, false);
+    map_pages(gb, VRAM_START, VRAM_END, gb->mmu.vram, true);
+    map_extram(gb);
+    map_pages(gb, WRAM00_START, WRAM00_END, gb->mmu.wram00, true);
+    map_pages(gb, WRAMNN_START, WRAMNN_END, gb->mmu.wramNN, true);
+    map_pages(gb, WRAM00_MIRROR_START, WRAM00_MIRROR_END, gb->mmu.wram00, true);
+    map_pages(gb, WRAMNN_MIRROR_START, WRAMNN_MIRROR_END, gb->mmu.wramNN, true);
+}
+
+static void map_pages(GameBoy *gb, const uint16_t start, const uint16_t end, uint8_t *mem, const bool is_writable) {
+    for (uint16_t page = start >> MMU_PAGE_SHIFT; page <= end >> MMU_PAGE_SHIFT; ++page) {
+        uint8_t *host = mem != NULL ? mem + ((page << MMU_PAGE_SHIFT) - start) : NULL;
+
+        gb->mmu.read_pages[page] = host;
+        gb->mmu.write_pages[page] = is_writable ? host : NULL;
+    }
+
+    // The instruction fetch cache may point into the old mapping
+    gb->cpu.fetch.length = 0;
+}
+
+// Writes to a bank of cart ram take the slow path until it is marked dirty for the next save
+static void map_extram(GameBoy *gb) {
+    const bool is_dirty = gb->mmu.extram != NULL && GET_BIT(gb->cart.dirty_banks, gb->mmu.ram_bank);
+    map_pages(gb, EXTRAM_START, EXTRAM_END, gb->mmu.extram, is_dirty);
 }
 
 static uint8_t *get_memory(GameBoy *gb, uint16_t *address) {
@@ -119,6 +267,12 @@ static uint8_t *get_memory(GameBoy *gb, uint16_t *address) {
     return NULL;
 }
 
+// Cart ram with no bank mapped, which the MBC may still answer to
+static bool is_mbc_ram(GameBoy *gb, const uint16_t address) {
+    return address >= EXTRAM_START && address <= EXTRAM_END && gb->mmu.extram == NULL && gb->mmu.mbc != NULL &&
+           gb->mmu.mbc->read_ram != NULL;
+}
+
 static bool is_accessible(GameBoy *gb, const uint16_t address) {
     if (address >= UNUSABLE_START && address <= UNUSABLE_END) {
         return false;
@@ -132,38 +286,30 @@ static bool is_accessible(GameBoy *gb, const uint16_t address) {
 }
 
 uint8_t read_byte(GameBoy *gb, uint16_t address, const bool is_program) {
-    if (is_program && address == JOYP) {
-        return joypad_state(gb);
-    }
+    const uint8_t *page = gb->mmu.read_pages[address >> MMU_PAGE_SHIFT];
 
-    if (!is_accessible(gb, address)) {
-        return 0xFF;
+    if (page != NULL) {
+        return page[address & 0xFF];
     }
 
-    if (address == HDMA5) {
-        return (!gb->mmu.hdma.is_active << 7) | (0x1F);
+    if (address >= IO_START && address <= IO_END) {
+        return read_io(gb, address, is_program);
     }
 
-    if (gb->mmu.dma.is_active && gb->mmu.dma.clock > 0 && address >= OAM_START && address <= OAM_END) {
-        return 0xFF;
+    if (is_mbc_ram(gb, address)) {
+        return gb->mmu.mbc->read_ram(gb, address);
     }
 
-    if (address >= UNUSED_AUDIO_START && address < WAVE_TABLE_START) {
-        // Above the NR registers, all data is set to FF
+    if (!is_accessible(gb, address)) {
         return 0xFF;
     }
 
-    uint16_t relative_addr = address;
-    const uint8_t *mem = get_memory(gb, &relative_addr);
-    uint8_t data = mem[relative_addr];
-
-    if (address >= NR10 && address <= NR52) {
-        data = audio_register_read(gb, address, data);
-    } else if (address == KEY1) {
-        data = (data & 0x7F) | (gb->cpu.is_double_speed << 7);
+    if (gb->mmu.dma.is_active && address >= OAM_START && address <= OAM_END) {
+        return 0xFF;
     }
 
-    return data;
+    const uint8_t *mem = get_memory(gb, &address);
+    return mem[address];
 }
 
 uint16_t read_short(GameBoy *gb, const uint16_t address, const bool is_program) {
@@ -174,11 +320,52 @@ uint16_t read_short(GameBoy *gb, const uint16_t address, const bool is_program)
 }
 
 void write_byte(GameBoy *gb, uint16_t address, uint8_t value, const bool is_program) {
+    uint8_t *page = gb->mmu.write_pages[address >> MMU_PAGE_SHIFT];
+
+    if (page != NULL) {
+        track_code_write(gb, address);
+        page[address & 0xFF] = value;
+        return;
+    }
+
     if (address <= ROMNN_END) {
-        if (gb->mmu.mbc_handler != NULL) {
-            gb->mmu.mbc_handler(gb, address, value);
+        if (gb->mmu.mbc != NULL) {
+            const uint8_t *rom00 = gb->mmu.rom00;
+            const uint8_t *romNN = gb->mmu.romNN;
+            const uint8_t *extram = gb->mmu.extram;
+
+            gb->mmu.mbc->write(gb, address, value);
+
+            // Only remap the regions that moved, some games switch banks very often
+            if (gb->mmu.rom00 != rom00) {
+                map_pages(gb, ROM00_START, ROM00_END, gb->mmu.rom00, false);
+            }
+
+            if (gb->mmu.romNN != romNN) {
+                map_pages(gb, ROMNN_START, ROMNN_END, gb->mmu.romNN, false);
+            }
+
+            if (gb->mmu.extram != extram) {
+                map_extram(gb);
+            }
         }
 
+        // A bank switch changes the code the running block was compiled from
+        gb->block_cache.is_stale = true;
+
+        return;
+    }
+
+    if (is_mbc_ram(gb, address)) {
+        gb->mmu.mbc->write_ram(gb, address, value);
+        return;
+    }
+
+    // The first write to a bank of cart ram marks it, the next ones take the fast path
+    if (address >= EXTRAM_START && address <= EXTRAM_END && gb->mmu.extram != NULL) {
+        gb->cart.dirty_banks |= 1 << gb->mmu.ram_bank;
+        map_extram(gb);
+        gb->mmu.extram[address - EXTRAM_START] = value;
         return;
     }
 
@@ -186,57 +373,169 @@ void write_byte(GameBoy *gb, uint16_t address, uint8_t value, const bool is_prog
         return;
     }
 
-    if (is_program) {
-        if (address == SB && gb->mmu.serial_write_handler != NULL) {
-            gb->mmu.serial_write_handler(value);
-            return;
-        }
+    if (address >= IO_START && address <= IO_END) {
+        write_io(gb, address, value, is_program);
+        return;
+    }
 
-        if (address == DMA) {
-            trigger_dma(gb, value);
-        }
+    const bool is_interrupt_register = address == IE;
+    track_code_write(gb, address);
 
-        if (address == DIV) {
-            set_div(gb, 0);
-            value = 0x0;
-        }
+    uint8_t *mem = get_memory(gb, &address);
+    mem[address] = value;
 
-        if (address == LY) {
-            value = 0x0;
-        }
+    if (is_interrupt_register) {
+        update_pending_interrupts(gb);
+    }
+}
 
-        if (address >= NR10 && address <= NR52) {
-            // Ignore APU register writes when APU is disabled
-            // Unless we're changing the control register
-            if (!gb->apu.enabled && address != NR52) {
-                return;
-            }
+static uint8_t read_io(GameBoy *gb, const uint16_t address, const bool is_program) {
+    const IORegister *reg = &io_registers[address - IO_START];
+    uint8_t data = gb->mmu.io[address - IO_START];
 
-            audio_register_write(gb, address, value);
-        }
+    // Internal reads see the stored byte, some handlers change it
+    if (is_program && reg->read != NULL) {
+        data = reg->read(gb, address, data);
+    }
 
-        if (address == VBK) {
-            const uint8_t bank = GET_BIT(value, VBK_BANK);
+    return is_program ? data | reg->read_mask : data;
+}
 
-            gb->mmu.vram_bank = bank;
-            gb->mmu.vram = gb->mmu.vram_banks[bank];
-        }
+static void write_io(GameBoy *gb, const uint16_t address, uint8_t value, const bool is_program) {
+    const IORegister *reg = &io_registers[address - IO_START];
 
-        if (address == BGPI || address == OBPI) {
-            palette_index_write(gb, address, value);
-        }
+    if (is_program && reg->write != NULL && !reg->write(gb, address, &value)) {
+        return;
+    }
 
-        if (address == BGPD || address == OBPD) {
-            palette_data_write(gb, address, value);
-        }
+    gb->mmu.io[address - IO_START] = value;
 
-        if (address >= HDMA1 && address <= HDMA5) {
-            hdma_write(gb, address, value);
-        }
+    if (address == IF) {
+        update_pending_interrupts(gb);
     }
+}
 
-    uint8_t *mem = get_memory(gb, &address);
-    mem[address] = value;
+static uint8_t joypad_read(GameBoy *gb, const uint16_t address, const uint8_t data) {
+    return joypad_state(gb, data);
+}
+
+static uint8_t unused_read(GameBoy *gb, const uint16_t address, const uint8_t data) {
+    return 0xFF;
+}
+
+static uint8_t timer_read(GameBoy *gb, const uint16_t address, const uint8_t data) {
+    return timer_register_read(gb, address, data);
+}
+
+static uint8_t audio_read(GameBoy *gb, const uint16_t address, const uint8_t data) {
+    return audio_register_read(gb, address, data);
+}
+
+static uint8_t key1_read(GameBoy *gb, const uint16_t address, const uint8_t data) {
+    return (data & 0x7F) | (gb->cpu.is_double_speed << 7);
+}
+
+// Blocks left minus one, FF once a transfer has completed
+static uint8_t hdma5_read(GameBoy *gb, const uint16_t address, const uint8_t data) {
+    const uint8_t blocks = ((gb->mmu.hdma.length / HDMA_BLOCK_SIZE) - 1) & HDMA5_LENGTH;
+    return (!gb->mmu.hdma.is_active << 7) | blocks;
+}
+
+static bool serial_write(GameBoy *gb, const uint16_t address, uint8_t *value) {
+    if (gb->mmu.serial_write_handler != NULL) {
+        gb->mmu.serial_write_handler(gb->mmu.serial_user_data, *value);
+        return false;
+    }
+
+    return true;
+}
+
+static bool timer_write(GameBoy *gb, const uint16_t address, uint8_t *value) {
+    timer_register_write(gb, address, *value);
+    return true;
+}
+
+static bool audio_write(GameBoy *gb, const uint16_t address, uint8_t *value) {
+    // Ignore APU register writes when APU is disabled
+    // Unless we're changing the control register
+    if (!gb->apu.enabled && address != NR52) {
+        return false;
+    }
+
+    audio_register_write(gb, address, *value);
+    return true;
+}
+
+static bool lcdc_register_write(GameBoy *gb, const uint16_t address, uint8_t *value) {
+    lcdc_write(gb, *value);
+    return true;
+}
+
+static bool stat_write(GameBoy *gb, const uint16_t address, uint8_t *value) {
+    // The mode and coincidence flag are read only
+    *value = (*value & ~0x7) | (IREAD8(STAT) & 0x7);
+    return true;
+}
+
+static bool ly_write(GameBoy *gb, const uint16_t address, uint8_t *value) {
+    *value = 0x0;
+    return true;
+}
+
+static bool dma_write(GameBoy *gb, const uint16_t address, uint8_t *value) {
+    trigger_dma(gb, *value);
+    return true;
+}
+
+static bool vbk_write(GameBoy *gb, const uint16_t address, uint8_t *value) {
+    const uint8_t bank = GET_BIT(*value, VBK_BANK);
+
+    gb->mmu.vram_bank = bank;
+    gb->mmu.vram = gb->mmu.vram_banks[bank];
+    map_pages(gb, VRAM_START, VRAM_END, gb->mmu.vram, true);
+
+    return true;
+}
+
+static bool hdma_register_write(GameBoy *gb, const uint16_t address, uint8_t *value) {
+    hdma_write(gb, address, *value);
+    return true;
+}
+
+static bool palette_index_register_write(GameBoy *gb, const uint16_t address, uint8_t *value) {
+    palette_index_write(gb, address, *value);
+    return true;
+}
+
+static bool palette_data_register_write(GameBoy *gb, const uint16_t address, uint8_t *value) {
+    palette_data_write(gb, address, *value);
+    return true;
+}
+
+// Switches the upper 4KB of work RAM, bank 0 selects bank 1
+static bool svbk_write(GameBoy *gb, const uint16_t address, uint8_t *value) {
+    (void) address;
+
+    if (!gb->cart.image->is_colour) {
+        return true;
+    }
+
+    uint8_t bank = *value & SVBK_BANK;
+
+    if (bank == 0) {
+        bank = 1;
+    }
+
+    gb->mmu.wram_bank = bank;
+    gb->mmu.wramNN = gb->mmu.wram_banks[bank];
+
+    map_pages(gb, WRAMNN_START, WRAMNN_END, gb->mmu.wramNN, true);
+    map_pages(gb, WRAMNN_MIRROR_START, WRAMNN_MIRROR_END, gb->mmu.wramNN, true);
+
+    // The running block may have been decoded from the other bank
+    gb->block_cache.is_stale = true;
+
+    return true;
 }
 
 void write_short(GameBoy *gb, const uint16_t address, const uint16_t value, const bool is_program) {
@@ -261,36 +560,34 @@ uint8_t read_register(GameBoy *gb, const uint16_t address, const uint8_t bit) {
 
 static void trigger_dma(GameBoy *gb, const uint8_t value) {
     gb->mmu.dma.is_active = true;
-    gb->mmu.dma.clock = 0;
     gb->mmu.dma.address = value * 0x100;
+
+    schedule_event(gb, EventDMA, gb->scheduler.cycles + DMA_CLOCKS);
 }
 
+// Called when the OAM DMA transfer completes
 void update_dma(GameBoy *gb) {
     if (!gb->mmu.dma.is_active) {
         return;
     }
 
-    gb->mmu.dma.clock += gb->cpu.ticks;
-
-    if (gb->mmu.dma.clock >= DMA_CLOCKS) {
-        for (uint8_t i = 0; i <= 0x9F; ++i)  {
-            SWRITE8(0xFE00 + i, SREAD8(gb->mmu.dma.address + i));
-        }
-
-        gb->mmu.dma.is_active = false;
-    }
+    copy_memory(gb, gb->mmu.oam, gb->mmu.dma.address, DMA_LENGTH);
+    gb->mmu.dma.is_active = false;
 }
 
+// Called when the PPU enters HBlank, an HBlank transfer copies its next block
 void update_hdma(GameBoy *gb) {
-    if (!gb->mmu.hdma.is_active) {
+    if (!gb->mmu.hdma.is_active || gb->mmu.hdma.mode != HBlankDMA) {
         return;
     }
 
-    for (uint8_t i = 0; i < gb->mmu.hdma.length; ++i) {
-        SWRITE8(gb->mmu.hdma.dest_addr + i, SREAD8(gb->mmu.hdma.source_addr + i));
-    }
+    copy_hdma_block(gb);
 
-    gb->mmu.hdma.is_active = false;
+    // The rest of the system keeps running while the CPU waits for the copy
+    if (!gb->cpu.is_halted) {
+        gb->scheduler.cycles += HDMA_BLOCK_CLOCKS;
+        tick_timer(gb, HDMA_BLOCK_CLOCKS << gb->cpu.is_double_speed);
+    }
 }
 
 static void hdma_write(GameBoy *gb, const uint16_t addr, const uint8_t value) {
@@ -306,21 +603,72 @@ static void hdma_write(GameBoy *gb, const uint16_t addr, const uint8_t value) {
 
     case HDMA3:
         gb->mmu.hdma.dest_addr = (gb->mmu.hdma.dest_addr & 0xFF) | (value << 8);
-        gb->mmu.hdma.dest_addr &= 0x1FFF; // Upper 4 bits are ignored
+        gb->mmu.hdma.dest_addr &= 0x1FF0; // Upper 3 bits are ignored, the destination is always in VRAM
         break;
 
     case HDMA4:
         gb->mmu.hdma.dest_addr = (gb->mmu.hdma.dest_addr & 0xFF00) | value;
-        gb->mmu.hdma.source_addr &= 0xFFF0;
+        gb->mmu.hdma.dest_addr &= 0x1FF0;
         break;
 
     case HDMA5:
-        gb->mmu.hdma.length = (value & HDMA5_LENGTH) * 0x10 + 1;
+        // Clearing bit 7 stops an HBlank transfer, the remaining length can still be read
+        if (gb->mmu.hdma.is_active && gb->mmu.hdma.mode == HBlankDMA && !(value & HDMA5_MODE)) {
+            gb->mmu.hdma.is_active = false;
+            break;
+        }
+
+        gb->mmu.hdma.length = ((value & HDMA5_LENGTH) + 1) * HDMA_BLOCK_SIZE;
         gb->mmu.hdma.mode = (value & HDMA5_MODE) >> 7;
         gb->mmu.hdma.is_active = true;
+
+        // A general purpose transfer copies everything at once, the CPU is stopped until it is done
+        if (gb->mmu.hdma.mode == GeneralPurposeDMA) {
+            uint32_t steps = 0;
+
+            while (gb->mmu.hdma.is_active) {
+                copy_hdma_block(gb);
+                steps += (HDMA_BLOCK_CLOCKS / CPU_STEP) << gb->cpu.is_double_speed;
+            }
+
+            TICK(steps);
+        }
+        // Without HBlanks to wait for, the first block is copied straight away
+        else if (!RREG(LCDC, LCDC_LCD_ENABLE) || (IREAD8(STAT) & 0x3) == HBlank) {
+            copy_hdma_block(gb);
+        }
         break;
 
     default:
         ASSERT_NOT_REACHED();
     }
 }
+
+static void copy_hdma_block(GameBoy *gb) {
+    const uint16_t dest = gb->mmu.hdma.dest_addr;
+    copy_memory(gb, gb->mmu.vram + dest, gb->mmu.hdma.source_addr, HDMA_BLOCK_SIZE);
+
+    gb->mmu.hdma.source_addr += HDMA_BLOCK_SIZE;
+    gb->mmu.hdma.dest_addr = (dest + HDMA_BLOCK_SIZE) & 0x1FF0;
+    gb->mmu.hdma.length -= HDMA_BLOCK_SIZE;
+
+    // The destination wraps at the end of VRAM, which also ends the transfer
+    if (gb->mmu.hdma.length == 0 || gb->mmu.hdma.dest_addr == 0) {
+        gb->mmu.hdma.is_active = false;
+    }
+}
+
+// Copies length bytes from the bus to dest, as a single block copy when the source is in plain memory
+// The source never crosses a page, DMA sources are page aligned and HDMA blocks 16 byte aligned
+static void copy_memory(GameBoy *gb, uint8_t *dest, const uint16_t source, const uint16_t length) {
+    const uint8_t *page = gb->mmu.read_pages[source >> MMU_PAGE_SHIFT];
+
+    if (page != NULL) {
+        memcpy(dest, page + (source & 0xFF), length);
+        return;
+    }
+
+    for (uint16_t i = 0; i < length; ++i) {
+        dest[i] = SREAD8(source + i);
+    }
+}
@@ -1,12 +1,15 @@
 #include "ppu.h"
+#include "arena.h"
 #include "cpu.h"
 #include "macro.h"
 #include "mmu.h"
+#include "scheduler.h"
 #include <assert.h>
 #include <stdlib.h>
 #include <string.h>
 
-static void update_render_mode(GameBoy *, uint8_t, bool);
+static void end_scanline(GameBoy *, uint8_t);
+static void set_render_mode(GameBoy *, PPUMode);
 
 static bool get_bg_tile_data_start(GameBoy *, uint16_t *);
 static uint16_t get_tile_map_offset(Position);
@@ -27,145 +30,132 @@ static void fill_shade_table(uint8_t, uint16_t *);
 static void fill_colour_table(uint8_t, uint16_t *, uint16_t *);
 
 void init_ppu(GameBoy *gb) {
-    gb->ppu.framebuffer = malloc(SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(uint16_t));
-    gb->ppu.sprite_buffer = malloc(10 * sizeof(Sprite));
+    gb->ppu.framebuffer = gb->arena->framebuffer;
+    gb->ppu.sprite_buffer = gb->arena->sprite_buffer;
 
-    gb->ppu.window = NULL;
-    gb->ppu.renderer = NULL;
-    gb->ppu.texture = NULL;
+    gb->ppu.frame_handler = NULL;
+    gb->ppu.frame_user_data = NULL;
 }
 
 void reset_ppu(GameBoy *gb) {
-    gb->ppu.scan_clock = 0;
-    gb->ppu.frame_clock = 0;
     gb->ppu.window_ly = 0;
     gb->ppu.sprite_count = 0;
 
     memset(gb->ppu.framebuffer, 0, SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(int16_t));
-    memset(gb->ppu.sprite_buffer, 0, 10 * sizeof(Sprite));
+    memset(gb->ppu.sprite_buffer, 0, SPRITES_PER_LINE * sizeof(Sprite));
     memset(gb->ppu.bg_palette, 0, 32 * sizeof(uint16_t));
     memset(gb->ppu.obj_palette, 0, 32 * sizeof(uint16_t));
-}
-
-void init_window(GameBoy *gb) {
-    gb->ppu.window = SDL_CreateWindow(WINDOW_TITLE, SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
-                                      SCREEN_WIDTH * SCREEN_INITIAL_SCALE, SCREEN_HEIGHT * SCREEN_INITIAL_SCALE,
-                                      SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE);
-
-    gb->ppu.renderer = SDL_CreateRenderer(gb->ppu.window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
 
-    SDL_RenderSetLogicalSize(gb->ppu.renderer, SCREEN_WIDTH, SCREEN_HEIGHT);
-    SDL_SetWindowMinimumSize(gb->ppu.window, SCREEN_WIDTH, SCREEN_HEIGHT);
-
-    SDL_DisplayMode mode;
-    mode.refresh_rate = FRAMERATE;
-    SDL_SetWindowDisplayMode(gb->ppu.window, &mode);
-
-    gb->ppu.texture = SDL_CreateTexture(gb->ppu.renderer, SDL_PIXELFORMAT_ABGR1555, SDL_TEXTUREACCESS_STREAMING,
-                                        SCREEN_WIDTH, SCREEN_HEIGHT);
+    // The LCD is enabled when the hardware registers are reset, start the first scanline
+    IWRITE8(STAT, (IREAD8(STAT) & ~0x3) | OamTransfer);
+    schedule_event(gb, EventPPU, gb->scheduler.cycles + OAM_TRANSFER_CLOCKS);
 }
 
-void render_framebuffer(GameBoy *gb) {
-    SDL_SetRenderDrawColor(gb->ppu.renderer, 0, 0, 0, 255);
-    SDL_RenderClear(gb->ppu.renderer);
-
-    SDL_UpdateTexture(gb->ppu.texture, NULL, gb->ppu.framebuffer, SCREEN_WIDTH * sizeof(uint16_t));
+// Called when the current mode ends, moves to the next mode and schedules its end
+void update_ppu(GameBoy *gb, const uint64_t time) {
+    const PPUMode mode = IREAD8(STAT) & 0x3;
+
+    switch (mode) {
+    case OamTransfer:
+        set_render_mode(gb, PixelTransfer);
+        schedule_event(gb, EventPPU, time + PIXEL_TRANSFER_CLOCKS);
+        break;
+
+    case PixelTransfer:
+        set_render_mode(gb, HBlank);
+        schedule_event(gb, EventPPU, time + HBLANK_CLOCKS);
+        update_hdma(gb);
+        break;
+
+    case HBlank:
+    case VBlank: {
+        end_scanline(gb, IREAD8(LY));
+        const uint8_t ly = IREAD8(LY);
+
+        // V-Blank (10 lines)
+        if (ly >= 144) {
+            set_render_mode(gb, VBlank);
+            schedule_event(gb, EventPPU, time + CLOCKS_PER_SCANLINE);
+        }
+        // Screen rendering (144 lines aka height of screen in px)
+        else {
+            set_render_mode(gb, OamTransfer);
+            schedule_event(gb, EventPPU, time + OAM_TRANSFER_CLOCKS);
+        }
+        break;
+    }
 
-    SDL_RenderCopy(gb->ppu.renderer, gb->ppu.texture, NULL, NULL);
-    SDL_RenderPresent(gb->ppu.renderer);
+    default:
+        ASSERT_NOT_REACHED();
+    }
 }
 
-void update_ppu(GameBoy *gb) {
-    const bool lcd_on = RREG(LCDC, LCDC_LCD_ENABLE);
-    uint8_t ly = SREAD8(LY);
-
-    update_render_mode(gb, ly, lcd_on);
+static void end_scanline(GameBoy *gb, uint8_t ly) {
+    perform_sprite_search(gb, ly);
 
-    if (!lcd_on) {
-        SWRITE8(LY, 0);
-        gb->ppu.scan_clock = 0;
-        gb->ppu.window_ly = 0;
-        return;
+    // Render scanlines (144 pixel tall screen)
+    if (ly < 144) {
+        render_bg_scan(gb, ly);
+        render_window_scan(gb, ly);
+        render_sprite_scan(gb, ly);
     }
+    // End of frame, request vblank interrupt
+    else if (ly == 144) {
+        WREG(IF, IEF_VBLANK, 1);
 
-    gb->ppu.scan_clock += gb->cpu.ticks;
-
-    if (gb->ppu.scan_clock >= CLOCKS_PER_SCANLINE) {
-        gb->ppu.scan_clock = 0;
-        perform_sprite_search(gb, ly);
-
-        // Render scanlines (144 pixel tall screen)
-        if (ly < 144) {
-            render_bg_scan(gb, ly);
-            render_window_scan(gb, ly);
-            render_sprite_scan(gb, ly);
-        }
-        // End of frame, request vblank interrupt
-        else if (ly == 144) {
-            WREG(IF, IEF_VBLANK, 1);
-
-            if (gb->ppu.window != NULL) {
-                render_framebuffer(gb);
-            }
+        if (gb->ppu.frame_handler != NULL) {
+            gb->ppu.frame_handler(gb->ppu.frame_user_data, gb->ppu.framebuffer);
         }
+    }
 
-        if (ly == 153) {
-            ly = 0;
-            gb->ppu.window_ly = 0;
-        } else {
-            ly++;
+    if (ly == 153) {
+        ly = 0;
+        gb->ppu.window_ly = 0;
+    } else {
+        ly++;
 
-            if (SREAD8(WX) < SCREEN_WIDTH - 1 + 7 && SREAD8(WY) < SCREEN_HEIGHT - 1) {
-                gb->ppu.window_ly++;
-            }
+        if (IREAD8(WX) < SCREEN_WIDTH - 1 + 7 && IREAD8(WY) < SCREEN_HEIGHT - 1) {
+            gb->ppu.window_ly++;
         }
+    }
 
-        SWRITE8(LY, ly);
+    IWRITE8(LY, ly);
 
-        // Check if LY == LYC
-        // And request an interrupt
-        if (SREAD8(LYC) == ly) {
-            WREG(STAT, STAT_COINCID_FLAG, 1);
+    // Check if LY == LYC
+    // And request an interrupt
+    if (IREAD8(LYC) == ly) {
+        WREG(STAT, STAT_COINCID_FLAG, 1);
 
-            // If the LY == LYC interrupt is enabled, request it
-            if (RREG(STAT, STAT_COINCID_INT)) {
-                WREG(IF, IEF_LCD_STAT, 1);
-            }
-        } else {
-            WREG(STAT, STAT_COINCID_FLAG, 0);
+        // If the LY == LYC interrupt is enabled, request it
+        if (RREG(STAT, STAT_COINCID_INT)) {
+            WREG(IF, IEF_LCD_STAT, 1);
         }
+    } else {
+        WREG(STAT, STAT_COINCID_FLAG, 0);
     }
 }
 
-// Updates the mode in the STAT register based on the ly and scan clock
-static void update_render_mode(GameBoy *gb, const uint8_t ly, const bool lcd_on) {
-
-    const uint8_t curr_mode = SREAD8(STAT) & 0x3;
-    PPUMode new_mode = -1;
+// Updates the mode in the STAT register and requests the interrupt for the new mode if enabled
+static void set_render_mode(GameBoy *gb, const PPUMode new_mode) {
+    const uint8_t stat = IREAD8(STAT);
+    const uint8_t curr_mode = stat & 0x3;
     bool request_int = false;
 
-    // V-Blank (10 lines)
-    if (ly >= 144 || !lcd_on) {
-        new_mode = VBlank;
-        request_int = RREG(STAT, STAT_VBLANK_INT);
-    }
-    // Screen rendering (144 lines aka height of screen in px)
-    else {
+    switch (new_mode) {
+    case VBlank:
+        request_int = GET_BIT(stat, STAT_VBLANK_INT);
+        break;
 
-        // OAM Transfer
-        if (gb->ppu.scan_clock < 80) {
-            new_mode = OamTransfer;
-            request_int = RREG(STAT, STAT_OAM_INT);
-        }
-        // Pixel Transfer
-        else if (gb->ppu.scan_clock >= 80 && gb->ppu.scan_clock <= 252) {
-            new_mode = PixelTransfer;
-        }
-        // H-Blank
-        else if (gb->ppu.scan_clock > 252) {
-            new_mode = HBlank;
-            request_int = RREG(STAT, STAT_HBLANK_INT);
-        }
+    case OamTransfer:
+        request_int = GET_BIT(stat, STAT_OAM_INT);
+        break;
+
+    case HBlank:
+        request_int = GET_BIT(stat, STAT_HBLANK_INT);
+        break;
+
+    default:
+        break;
     }
 
     if (new_mode != curr_mode) {
@@ -175,8 +165,23 @@ static void update_render_mode(GameBoy *gb, const uint8_t ly, const bool lcd_on)
             WREG(IF, IEF_LCD_STAT, 1);
         }
 
-        WREG(STAT, STAT_MODE1, (new_mode >> 1) & 1);
-        WREG(STAT, STAT_MODE0, (new_mode >> 0) & 1);
+        IWRITE8(STAT, (stat & ~0x3) | new_mode);
+    }
+}
+
+// Turning the LCD off resets LY and stops the PPU, turning it back on starts a new frame
+void lcdc_write(GameBoy *gb, const uint8_t value) {
+    const bool was_on = RREG(LCDC, LCDC_LCD_ENABLE);
+    const bool is_on = GET_BIT(value, LCDC_LCD_ENABLE);
+
+    if (was_on && !is_on) {
+        cancel_event(gb, EventPPU);
+        IWRITE8(LY, 0);
+        gb->ppu.window_ly = 0;
+        set_render_mode(gb, VBlank);
+    } else if (!was_on && is_on) {
+        set_render_mode(gb, OamTransfer);
+        schedule_event(gb, EventPPU, gb->scheduler.cycles + OAM_TRANSFER_CLOCKS);
     }
 }
 
@@ -248,7 +253,7 @@ static inline void plot_tile_pixel(uint16_t *framebuffer, const Position display
 }
 
 static void render_bg_scan(GameBoy *gb, const uint8_t ly) {
-    if (!gb->cart.is_colour && !RREG(LCDC, LCDC_BG_DISPLAY)) {
+    if (!gb->cart.image->is_colour && !RREG(LCDC, LCDC_BG_DISPLAY)) {
         return;
     }
 
@@ -257,8 +262,8 @@ static void render_bg_scan(GameBoy *gb, const uint8_t ly) {
     uint16_t data_start = 0;
     const bool signed_tile_num = get_bg_tile_data_start(gb, &data_start);
 
-    const uint8_t scroll_x = SREAD8(SCX);
-    const uint8_t scroll_y = SREAD8(SCY);
+    const uint8_t scroll_x = IREAD8(SCX);
+    const uint8_t scroll_y = IREAD8(SCY);
 
     Position tile_pos = {0, scroll_y + ly};
     uint8_t tile_row_data[2];
@@ -273,11 +278,11 @@ static void render_bg_scan(GameBoy *gb, const uint8_t ly) {
             const uint16_t map_offset = get_tile_map_offset(tile_pos);
             const uint16_t map_addr = map_start + map_offset;
 
-            if (gb->cart.is_colour) {
+            if (gb->cart.image->is_colour) {
                 attributes = get_tile_attributes(gb, map_addr);
                 fill_colour_table(attributes.palette, gb->ppu.bg_palette, colours);
             } else {
-                fill_shade_table(SREAD8(BGP), colours);
+                fill_shade_table(IREAD8(BGP), colours);
             }
 
             const uint16_t data_addr = data_start + get_tile_data_offset(gb, map_addr, signed_tile_num);
@@ -306,8 +311,8 @@ static void render_window_scan(GameBoy *gb, const uint8_t ly) {
     uint16_t data_start;
     const bool signed_tile_num = get_bg_tile_data_start(gb, &data_start);
 
-    const uint8_t window_x = SREAD8(WX) - 7;
-    const uint8_t window_y = SREAD8(WY);
+    const uint8_t window_x = IREAD8(WX) - 7;
+    const uint8_t window_y = IREAD8(WY);
 
     Position tile_pos = {0, gb->ppu.window_ly - window_y};
     uint8_t tile_row_data[2];
@@ -328,11 +333,11 @@ static void render_window_scan(GameBoy *gb, const uint8_t ly) {
         if (scan_x == 0 || tile_pos.x % 8 == 0) {
             const uint16_t map_addr = map_start + get_tile_map_offset(tile_pos);
 
-            if (gb->cart.is_colour) {
+            if (gb->cart.image->is_colour) {
                 attributes = get_tile_attributes(gb, map_addr);
                 fill_colour_table(attributes.palette, gb->ppu.bg_palette, colours);
             } else {
-                fill_shade_table(SREAD8(BGP), colours);
+                fill_shade_table(IREAD8(BGP), colours);
             }
 
             const uint16_t data_addr = data_start + get_tile_data_offset(gb, map_addr, signed_tile_num);
@@ -365,12 +370,12 @@ static void render_sprite_scan(GameBoy *gb, const uint8_t ly) {
         const int16_t x = sprite.x - 8;
         const int16_t y = sprite.y - 16;
 
-        if (gb->cart.is_colour) {
+        if (gb->cart.image->is_colour) {
             const uint8_t palette = sprite.attributes & SPRITE_ATTR_CGB_PALETTE_MASK;
             fill_colour_table(palette, gb->ppu.obj_palette, colours);
         } else {
             const uint16_t palette_addr = GET_BIT(sprite.attributes, SPRITE_ATTR_DMG_PALETTE) ? OBP1 : OBP0;
-            const uint8_t palette = SREAD8(palette_addr);
+            const uint8_t palette = IREAD8(palette_addr);
             fill_shade_table(palette, colours);
         }
 
@@ -385,7 +390,7 @@ static void render_sprite_scan(GameBoy *gb, const uint8_t ly) {
         const uint16_t row_offset = (tile_number * 16) + row_index * 2;
         uint8_t data[2];
 
-        if (gb->cart.is_colour) {
+        if (gb->cart.image->is_colour) {
             const uint8_t bank = GET_BIT(sprite.attributes, SPRITE_ATTR_BANK);
             memcpy(data, gb->mmu.vram_banks[bank] + row_offset, 2);
         } else {
@@ -417,7 +422,7 @@ static void render_sprite_scan(GameBoy *gb, const uint8_t ly) {
 
             bool should_draw = false;
 
-            if (gb->cart.is_colour) {
+            if (gb->cart.image->is_colour) {
                 const bool bg_has_priority_tile = gb->ppu.current_scan_bg_has_priority[scan_x];
                 const uint8_t bg_colour_num = gb->ppu.current_scan_bg_colour[scan_x];
                 should_draw = bg_colour_num == 0
@@ -461,7 +466,7 @@ static void perform_sprite_search(GameBoy *gb, const uint8_t ly) {
         if (y <= ly && y + height > ly) {
             gb->ppu.sprite_buffer[count] = sprite;
 
-            if (++count == 10) {
+            if (++count == SPRITES_PER_LINE) {
                 break;
             }
         }
@@ -472,7 +477,7 @@ static void perform_sprite_search(GameBoy *gb, const uint8_t ly) {
     // On CGB, sprites are prioritised based on their position in the OAM
     // On DMG, sprites are prioritised based on their x coordinate
     if (count > 0) {
-        if (gb->cart.is_colour) {
+        if (gb->cart.image->is_colour) {
             for (uint8_t i = 0; i < count / 2; ++i) {
                 const Sprite copy = gb->ppu.sprite_buffer[i];
                 gb->ppu.sprite_buffer[i] = gb->ppu.sprite_buffer[count - 1 - i];
@@ -550,7 +555,7 @@ void palette_index_write(GameBoy *gb, const uint16_t address, const uint8_t valu
         data = (colour & 0xFF00) >> 8;
     }
 
-    SWRITE8(data_reg_addr, data);
+    IWRITE8(data_reg_addr, data);
 }
 
 void palette_data_write(GameBoy *gb, const uint16_t address, const uint8_t value) {
@@ -567,7 +572,7 @@ void palette_data_write(GameBoy *gb, const uint16_t address, const uint8_t value
         index_reg_addr = OBPI;
     }
 
-    const uint8_t index_reg = SREAD8(index_reg_addr);
+    const uint8_t index_reg = IREAD8(index_reg_addr);
     const uint8_t index = index_reg & PI_INDEX;
 
     uint16_t *colour = &palette[index / 2];
@@ -585,6 +590,6 @@ void palette_data_write(GameBoy *gb, const uint16_t address, const uint8_t value
 
     if (auto_incr) {
         const uint8_t new_index = (index + 1) % PI_INDEX;
-        SWRITE8(index_reg_addr, (index_reg & ~PI_INDEX) | new_index);
+        IWRITE8(index_reg_addr, (index_reg & ~PI_INDEX) | new_index);
     }
 }
@@ -0,0 +1,80 @@
+#include "recomp.h"
+#include "mmu.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef RECOMP
+#include <dlfcn.h>
+#endif
+
+// FNV-1a of every rom bank, ties a recompiled library to the rom it was built from
+uint64_t hash_rom(GameBoy *gb) {
+    uint64_t hash = 0xCBF29CE484222325;
+
+    for (uint16_t bank = 0; bank < gb->cart.image->rom_size; ++bank) {
+        for (uint16_t i = 0; i < ROM_BANK_SIZE; ++i) {
+            hash ^= gb->cart.image->rom_banks[bank][i];
+            hash *= 0x100000001B3;
+        }
+    }
+
+    return hash;
+}
+
+// Loads the library built by jgbc_recomp for the current rom
+// Its blocks replace the decoded ones as they get cached
+bool load_recompiled(GameBoy *gb) {
+#ifdef RECOMP
+    char filename[256 + sizeof(RECOMP_EXTENSION) + 2];
+    snprintf(filename, sizeof(filename), "./%s%s", gb->cart.image->filename, RECOMP_EXTENSION);
+
+    void *library = dlopen(filename, RTLD_NOW);
+
+    if (library == NULL) {
+        return false;
+    }
+
+    const uint64_t *hash = dlsym(library, RECOMP_SYMBOL_HASH);
+    const uint32_t *layout = dlsym(library, RECOMP_SYMBOL_LAYOUT);
+    const RecompiledBlock *blocks = dlsym(library, RECOMP_SYMBOL_BLOCKS);
+    const uint32_t *block_count = dlsym(library, RECOMP_SYMBOL_BLOCK_COUNT);
+
+    // Built from another rom or against another version of the emulator
+    if (hash == NULL || layout == NULL || blocks == NULL || block_count == NULL || *hash != hash_rom(gb) ||
+        *layout != RECOMP_LAYOUT) {
+        dlclose(library);
+        return false;
+    }
+
+    gb->block_cache.recompiled = blocks;
+    gb->block_cache.recompiled_count = *block_count;
+    flush_blocks(gb);
+
+    return true;
+#else
+    (void) gb;
+    return false;
+#endif
+}
+
+// Recompiled code of the block at address in the given rom bank, NULL when it was not recompiled
+BlockCode find_recompiled(GameBoy *gb, const uint16_t bank, const uint16_t address) {
+    const uint32_t offset = bank * ROM_BANK_SIZE + address % ROM_BANK_SIZE;
+    uint32_t low = 0;
+    uint32_t high = gb->block_cache.recompiled_count;
+
+    while (low < high) {
+        const uint32_t middle = (low + high) / 2;
+        const RecompiledBlock *block = &gb->block_cache.recompiled[middle];
+
+        if (block->offset == offset) {
+            return block->code;
+        } else if (block->offset < offset) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return NULL;
+}
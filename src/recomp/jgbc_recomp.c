@@ -0,0 +1,495 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "arena.h"
+#include "block.h"
+#include "cart.h"
+#include "cpu.h"
+#include "gameboy.h"
+#include "instr.h"
+#include "mmu.h"
+#include "recomp.h"
+
+// Compiler used for the generated code, set by the build
+#ifndef RECOMP_CC
+#define RECOMP_CC "cc"
+#endif
+
+#ifndef RECOMP_CFLAGS
+#define RECOMP_CFLAGS ""
+#endif
+
+// Arguments of the compiler, the build flags included
+#define COMPILER_MAX_ARGS 64
+
+#define RST_VECTOR_COUNT 8
+#define INTERRUPT_VECTOR_COUNT 5
+
+// Longest statement written for an inlined instruction
+#define BODY_MAX_LENGTH 128
+
+typedef struct {
+    uint16_t bank;
+    uint16_t address;
+} Location;
+
+typedef struct {
+    Location *items;
+    uint32_t count;
+    uint32_t capacity;
+} LocationList;
+
+typedef struct {
+    GameBoy *gb;
+    FILE *output;
+    uint8_t *visited; // One bit per byte of the rom
+    LocationList pending;
+    LocationList blocks;
+} Recompiler;
+
+// Operands in the order of the opcode encoding, (HL) is the memory it points to
+static const char *const byte_operands[8] = {"REG(B)", "REG(C)", "REG(D)", "REG(E)",
+                                             "REG(H)", "REG(L)", "READ8(REG(HL))", "REG(A)"};
+static const char *const short_operands[4] = {"REG(BC)", "REG(DE)", "REG(HL)", "REG(SP)"};
+
+// ADD, ADC, SUB, SBC, AND, XOR, OR and CP, the compare keeps A
+static const char *const alu_helpers[8] = {"add_byte", "add_byte_carry", "sub_byte", "sub_byte_carry",
+                                           "and",      "xor",            "or",       "sub_byte"};
+
+// NZ, Z, NC and C
+static const char *const conditions[4] = {"!FGET(FLAG_ZERO)", "FGET(FLAG_ZERO)", "!FGET(FLAG_CARRY)",
+                                          "FGET(FLAG_CARRY)"};
+
+static void print_help();
+static void push_location(LocationList *, uint16_t, uint16_t);
+static void push_target(Recompiler *, uint16_t, uint16_t);
+static void push_successors(Recompiler *, uint16_t, const Block *, uint16_t);
+static bool recompile_block(Recompiler *, Location);
+static bool write_body(char *, const BlockInstruction *);
+static void write_prelude(Recompiler *);
+static void write_table(Recompiler *);
+static int compare_locations(const void *, const void *);
+static uint32_t location_offset(Location);
+static bool compile_library(const char *, const char *);
+
+int main(const int argc, const char **argv) {
+    if (argc < 2 || argc > 3) {
+        print_help();
+        return EXIT_FAILURE;
+    }
+
+    GameBoy *gb = calloc(1, sizeof(GameBoy));
+    init_arena(gb);
+    init_blocks(gb);
+
+    if (!load_rom(gb, argv[1])) {
+        fprintf(stderr, "ERROR: Cannot load rom file\n");
+        return EXIT_FAILURE;
+    }
+
+    char library_path[256 + sizeof(RECOMP_EXTENSION)];
+    char source_path[sizeof(library_path) + 2];
+    int library_length;
+
+    if (argc == 3) {
+        library_length = snprintf(library_path, sizeof(library_path), "%s", argv[2]);
+    } else {
+        library_length =
+            snprintf(library_path, sizeof(library_path), "%s%s", gb->cart.image->filename, RECOMP_EXTENSION);
+    }
+
+    // A truncated path would write and compile a different file
+    if (library_length < 0 || (size_t) library_length >= sizeof(library_path)) {
+        fprintf(stderr, "ERROR: Output path is too long\n");
+        return EXIT_FAILURE;
+    }
+
+    snprintf(source_path, sizeof(source_path), "%s.c", library_path);
+
+    Recompiler recompiler = {0};
+    recompiler.gb = gb;
+    recompiler.visited = calloc(gb->cart.image->rom_size * ROM_BANK_SIZE / 8, sizeof(uint8_t));
+    recompiler.output = fopen(source_path, "w");
+
+    if (recompiler.output == NULL) {
+        fprintf(stderr, "ERROR: Cannot write %s\n", source_path);
+        return EXIT_FAILURE;
+    }
+
+    write_prelude(&recompiler);
+
+    // Everything reachable from the entry point, the restarts and the interrupt handlers
+    push_target(&recompiler, 0, PROGRAM_START);
+
+    for (uint16_t i = 0; i < RST_VECTOR_COUNT; ++i) {
+        push_target(&recompiler, 0, i * 0x8);
+    }
+
+    for (uint16_t i = 0; i < INTERRUPT_VECTOR_COUNT; ++i) {
+        push_target(&recompiler, 0, INT_VBLANK + i * 0x8);
+    }
+
+    while (recompiler.pending.count > 0) {
+        const Location location = recompiler.pending.items[--recompiler.pending.count];
+        const uint32_t offset = location_offset(location);
+
+        if (recompiler.visited[offset >> 3] & (1 << (offset & 7))) {
+            continue;
+        }
+
+        recompiler.visited[offset >> 3] |= 1 << (offset & 7);
+
+        if (recompile_block(&recompiler, location)) {
+            push_location(&recompiler.blocks, location.bank, location.address);
+        }
+    }
+
+    write_table(&recompiler);
+    fclose(recompiler.output);
+
+    printf("Recompiled %u blocks of %s to %s\n", recompiler.blocks.count, gb->cart.image->title, source_path);
+
+    if (!compile_library(source_path, library_path)) {
+        fprintf(stderr, "ERROR: Cannot compile %s\n", source_path);
+        return EXIT_FAILURE;
+    }
+
+    printf("Written %s\n", library_path);
+    return EXIT_SUCCESS;
+}
+
+static void print_help() {
+    printf("Usage: jgbc_recomp <path to rom> <output library>?\n");
+    printf("Compiles the code reachable in the rom to a library loaded by jgbc --recomp.\n");
+    printf("The library is written to <rom file name>%s by default.\n", RECOMP_EXTENSION);
+}
+
+static void push_location(LocationList *list, const uint16_t bank, const uint16_t address) {
+    if (list->count == list->capacity) {
+        list->capacity = list->capacity == 0 ? 256 : list->capacity * 2;
+        list->items = realloc(list->items, list->capacity * sizeof(Location));
+    }
+
+    list->items[list->count++] = (Location){bank, address};
+}
+
+// Code in the switchable bank runs in the bank it was reached from
+// From the first bank, the target may be in any of them
+static void push_target(Recompiler *recompiler, const uint16_t bank, const uint16_t address) {
+    if (address <= ROM00_END) {
+        push_location(&recompiler->pending, 0, address);
+    } else if (address <= ROMNN_END) {
+        if (bank > 0) {
+            push_location(&recompiler->pending, bank, address);
+            return;
+        }
+
+        for (uint16_t i = 1; i < recompiler->gb->cart.image->rom_size; ++i) {
+            push_location(&recompiler->pending, i, address);
+        }
+    }
+}
+
+// Addresses the last instruction of the block can continue at
+static void push_successors(Recompiler *recompiler, const uint16_t bank, const Block *block, const uint16_t next) {
+    const BlockInstruction *last = &block->instructions[block->length - 1];
+
+    switch (last->opcode) {
+    // JR r8
+    case 0x18:
+        push_target(recompiler, bank, next + (int8_t) last->operand);
+        break;
+
+    // JR cc, r8
+    case 0x20: case 0x28: case 0x30: case 0x38:
+        push_target(recompiler, bank, next + (int8_t) last->operand);
+        push_target(recompiler, bank, next);
+        break;
+
+    // JP a16
+    case 0xC3:
+        push_target(recompiler, bank, last->operand);
+        break;
+
+    // JP cc, a16 and CALL
+    case 0xC2: case 0xCA: case 0xD2: case 0xDA:
+    case 0xC4: case 0xCC: case 0xCD: case 0xD4: case 0xDC:
+        push_target(recompiler, bank, last->operand);
+        push_target(recompiler, bank, next);
+        break;
+
+    // RST
+    case 0xC7: case 0xCF: case 0xD7: case 0xDF: case 0xE7: case 0xEF: case 0xF7: case 0xFF:
+        push_target(recompiler, bank, last->opcode & 0x38);
+        push_target(recompiler, bank, next);
+        break;
+
+    // RET, RETI and JP (HL) go to addresses only known at runtime
+    case 0xC9: case 0xD9: case 0xE9:
+        break;
+
+    default:
+        push_target(recompiler, bank, next);
+        break;
+    }
+}
+
+// Writes the function replaying the block at location, false when nothing there can be cached
+static bool recompile_block(Recompiler *recompiler, const Location location) {
+    GameBoy *gb = recompiler->gb;
+
+    gb->mmu.rom00 = gb->cart.image->rom_banks[0];
+    gb->mmu.romNN = gb->cart.image->rom_banks[location.bank > 0 ? location.bank : 1];
+    update_pages(gb);
+    REG(PC) = location.address;
+
+    const Block *block = find_block(gb);
+
+    if (block == NULL) {
+        // STOP is left to the interpreter, the code goes on after it
+        if (SREAD8(location.address) == 0x10) {
+            push_target(recompiler, location.bank, location.address + 2);
+        }
+
+        return false;
+    }
+
+    fprintf(recompiler->output, "static void block_%03x_%04x(GameBoy *gb) {\n", location.bank, location.address);
+
+    uint16_t address = location.address;
+
+    for (uint8_t i = 0; i < block->length; ++i) {
+        const BlockInstruction *instr = &block->instructions[i];
+        const Instruction *info = find_instr(gb, address);
+
+        char disassembly[32];
+        snprintf(disassembly, sizeof(disassembly), info->disassembly, instr->operand);
+
+        char body[BODY_MAX_LENGTH];
+
+        if (instr->opcode == 0xCB) {
+            fprintf(recompiler->output, "    STEP_CB(0x%02X, 0x%04X) // %s\n", instr->operand, address, disassembly);
+        } else if (write_body(body, instr)) {
+            fprintf(recompiler->output, "    BEGIN() %s END(0x%04X, %u) // %s\n", body, address, instr->length,
+                    disassembly);
+        } else {
+            fprintf(recompiler->output, "    STEP(0x%02X, 0x%04X, 0x%04X, %u) // %s\n", instr->opcode, instr->operand,
+                    address, instr->length, disassembly);
+        }
+
+        address += instr->length;
+    }
+
+    fprintf(recompiler->output, "}\n\n");
+
+    push_successors(recompiler, location.bank, block, address);
+    return true;
+}
+
+// Writes the statements of instructions simple enough to inline, in the same order as their handler
+// The operand is a constant, reading it only moves PC and takes its cycles
+static bool write_body(char *body, const BlockInstruction *instr) {
+    const uint8_t opcode = instr->opcode;
+    const uint8_t source = opcode & 0x7;
+    const uint8_t target = (opcode >> 3) & 0x7;
+    const char *fetch = instr->length == 3 ? "REG(PC) += 2; TICK(2);" : "REG(PC)++; TICK(1);";
+
+    // LD r, r', (HL) takes an extra cycle
+    if (opcode >= 0x40 && opcode <= 0x7F && opcode != 0x76) {
+        if (target == 0x6) {
+            snprintf(body, BODY_MAX_LENGTH, "WRITE8(REG(HL), %s); TICK(1);", byte_operands[source]);
+        } else {
+            snprintf(body, BODY_MAX_LENGTH, "%s = %s;%s", byte_operands[target], byte_operands[source],
+                     source == 0x6 ? " TICK(1);" : "");
+        }
+        return true;
+    }
+
+    // ALU A, r
+    if (opcode >= 0x80 && opcode <= 0xBF) {
+        snprintf(body, BODY_MAX_LENGTH, "%s%s(gb, REG(A), %s);%s", target == 0x7 ? "" : "REG(A) = ",
+                 alu_helpers[target], byte_operands[source], source == 0x6 ? " TICK(1);" : "");
+        return true;
+    }
+
+    // ALU A, d8
+    if ((opcode & 0xC7) == 0xC6) {
+        snprintf(body, BODY_MAX_LENGTH, "%s %s%s(gb, REG(A), 0x%02X);", fetch, target == 0x7 ? "" : "REG(A) = ",
+                 alu_helpers[target], instr->operand);
+        return true;
+    }
+
+    // INC r and DEC r
+    if ((opcode & 0xC6) == 0x04 && target != 0x6) {
+        snprintf(body, BODY_MAX_LENGTH, "%s = %s(gb, %s);", byte_operands[target], source == 0x4 ? "inc" : "dec",
+                 byte_operands[target]);
+        return true;
+    }
+
+    // LD r, d8
+    if ((opcode & 0xC7) == 0x06 && target != 0x6) {
+        snprintf(body, BODY_MAX_LENGTH, "%s %s = 0x%02X;", fetch, byte_operands[target], instr->operand);
+        return true;
+    }
+
+    // LD rr, d16
+    if ((opcode & 0xCF) == 0x01) {
+        snprintf(body, BODY_MAX_LENGTH, "%s %s = 0x%04X;", fetch, short_operands[opcode >> 4], instr->operand);
+        return true;
+    }
+
+    // INC rr and DEC rr
+    if ((opcode & 0xC7) == 0x03) {
+        snprintf(body, BODY_MAX_LENGTH, "%s%s; TICK(1);", short_operands[opcode >> 4],
+                 opcode & 0x8 ? "--" : "++");
+        return true;
+    }
+
+    switch (opcode) {
+    // JR r8 and JR cc, r8
+    case 0x18:
+        snprintf(body, BODY_MAX_LENGTH, "%s REG(PC) += %d; TICK(1);", fetch, (int8_t) instr->operand);
+        return true;
+
+    case 0x20: case 0x28: case 0x30: case 0x38:
+        snprintf(body, BODY_MAX_LENGTH, "%s if (%s) { REG(PC) += %d; TICK(1); }", fetch, conditions[target & 0x3],
+                 (int8_t) instr->operand);
+        return true;
+
+    // JP a16 and JP cc, a16
+    case 0xC3:
+        snprintf(body, BODY_MAX_LENGTH, "%s REG(PC) = 0x%04X; TICK(1);", fetch, instr->operand);
+        return true;
+
+    case 0xC2: case 0xCA: case 0xD2: case 0xDA:
+        snprintf(body, BODY_MAX_LENGTH, "%s if (%s) { REG(PC) = 0x%04X; TICK(1); }", fetch,
+                 conditions[target & 0x3], instr->operand);
+        return true;
+
+    // LDH (a8), A and LDH A, (a8)
+    case 0xE0:
+        snprintf(body, BODY_MAX_LENGTH, "%s WRITE8(0xFF%02X, REG(A)); TICK(1);", fetch, instr->operand);
+        return true;
+
+    case 0xF0:
+        snprintf(body, BODY_MAX_LENGTH, "%s REG(A) = READ8(0xFF%02X); TICK(1);", fetch, instr->operand);
+        return true;
+
+    // LD (a16), A and LD A, (a16)
+    case 0xEA:
+        snprintf(body, BODY_MAX_LENGTH, "%s WRITE8(0x%04X, REG(A)); TICK(1);", fetch, instr->operand);
+        return true;
+
+    case 0xFA:
+        snprintf(body, BODY_MAX_LENGTH, "%s REG(A) = READ8(0x%04X); TICK(1);", fetch, instr->operand);
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+// The generated code runs each instruction like run_block, calling the handlers directly
+static void write_prelude(Recompiler *recompiler) {
+    fprintf(recompiler->output, "// Generated by jgbc_recomp from %s, do not edit\n", recompiler->gb->cart.image->filename);
+    fprintf(recompiler->output, "#include \"alu.h\"\n");
+    fprintf(recompiler->output, "#include \"block.h\"\n");
+    fprintf(recompiler->output, "#include \"instr.h\"\n");
+    fprintf(recompiler->output, "#include \"mmu.h\"\n");
+    fprintf(recompiler->output, "#include \"recomp.h\"\n\n");
+
+    // Inlined instructions, their operand is part of the statements in between
+    fprintf(recompiler->output, "#define BEGIN() begin_block_instruction(gb, 0);\n");
+    fprintf(recompiler->output, "#define END(address, length)"
+                                " if (!end_block_instruction(gb, (address), (length))) return;\n\n");
+
+    fprintf(recompiler->output, "#define STEP(opcode, operand, address, length)"
+                                " begin_block_instruction(gb, (operand));"
+                                " opcode_handlers[(opcode)](gb);"
+                                " if (!end_block_instruction(gb, (address), (length))) return;\n\n");
+
+    // The prefix handler would only fetch the operand and execute it
+    fprintf(recompiler->output, "#define STEP_CB(opcode, address)"
+                                " begin_block_instruction(gb, (opcode));"
+                                " fetch_byte(gb);"
+                                " execute_cb(gb, (opcode));"
+                                " if (!end_block_instruction(gb, (address), 2)) return;\n\n");
+}
+
+static void write_table(Recompiler *recompiler) {
+    LocationList *blocks = &recompiler->blocks;
+    qsort(blocks->items, blocks->count, sizeof(Location), compare_locations);
+
+    fprintf(recompiler->output, "const uint64_t " RECOMP_SYMBOL_HASH " = 0x%016llXULL;\n",
+            (unsigned long long) hash_rom(recompiler->gb));
+    fprintf(recompiler->output, "const uint32_t " RECOMP_SYMBOL_LAYOUT " = RECOMP_LAYOUT;\n");
+    fprintf(recompiler->output, "const uint32_t " RECOMP_SYMBOL_BLOCK_COUNT " = %u;\n\n", blocks->count);
+
+    fprintf(recompiler->output, "const RecompiledBlock " RECOMP_SYMBOL_BLOCKS "[] = {\n");
+
+    for (uint32_t i = 0; i < blocks->count; ++i) {
+        const Location location = blocks->items[i];
+        fprintf(recompiler->output, "    {0x%06X, block_%03x_%04x},\n", location_offset(location), location.bank,
+                location.address);
+    }
+
+    fprintf(recompiler->output, "};\n");
+}
+
+static int compare_locations(const void *a, const void *b) {
+    const uint32_t offset_a = location_offset(*(const Location *) a);
+    const uint32_t offset_b = location_offset(*(const Location *) b);
+
+    return (offset_a > offset_b) - (offset_a < offset_b);
+}
+
+// Position in the rom file, the same key as find_recompiled
+static uint32_t location_offset(const Location location) {
+    return location.bank * ROM_BANK_SIZE + location.address % ROM_BANK_SIZE;
+}
+
+// Runs the compiler without a shell, the paths reach it as they are whatever characters they contain
+static bool compile_library(const char *source_path, const char *library_path) {
+    // The build passes the flags as one string
+    char flags[] = RECOMP_CFLAGS;
+    const char *args[COMPILER_MAX_ARGS] = {RECOMP_CC, "-O2", "-shared", "-fPIC"};
+    size_t count = 4;
+
+    for (char *flag = strtok(flags, " "); flag != NULL; flag = strtok(NULL, " ")) {
+        if (count == COMPILER_MAX_ARGS - 4) {
+            return false;
+        }
+
+        args[count++] = flag;
+    }
+
+    args[count++] = "-o";
+    args[count++] = library_path;
+    args[count++] = source_path;
+    args[count] = NULL;
+
+    // Keep the progress printed so far ahead of the messages of the compiler
+    fflush(stdout);
+    const pid_t pid = fork();
+
+    if (pid == -1) {
+        return false;
+    }
+
+    if (pid == 0) {
+        execvp(RECOMP_CC, (char *const *) args);
+        _exit(127);
+    }
+
+    int status;
+
+    if (waitpid(pid, &status, 0) == -1) {
+        return false;
+    }
+
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
@@ -0,0 +1,188 @@
+#include "scheduler.h"
+#include "apu.h"
+#include "cpu.h"
+#include "macro.h"
+#include "mmu.h"
+#include "ppu.h"
+#include <assert.h>
+
+static void swap_events(Scheduler *, uint8_t, uint8_t);
+static void sift_up(Scheduler *, uint8_t);
+static void sift_down(Scheduler *, uint8_t);
+static void remove_event(Scheduler *, uint8_t);
+static void dispatch_event(GameBoy *, Event);
+
+void reset_scheduler(GameBoy *gb) {
+    Scheduler *scheduler = &gb->scheduler;
+
+    scheduler->cycles = 0;
+    scheduler->deadline = 0;
+    scheduler->is_frame_done = false;
+    scheduler->queue_length = 0;
+
+    for (uint8_t i = 0; i < EVENT_COUNT; ++i) {
+        scheduler->queue_index[i] = -1;
+    }
+
+    schedule_event(gb, EventFrameEnd, FRAME_CYCLES);
+}
+
+// Schedules an event at an absolute time, replacing any pending event of the same type
+void schedule_event(GameBoy *gb, const EventType type, const uint64_t time) {
+    Scheduler *scheduler = &gb->scheduler;
+    assert(type < EVENT_COUNT);
+
+    // A write of the CPU can schedule an event during its run, stop there so it fires on time
+    if (time < scheduler->deadline) {
+        scheduler->deadline = time;
+    }
+
+    int8_t index = scheduler->queue_index[type];
+
+    if (index == -1) {
+        index = scheduler->queue_length++;
+        scheduler->queue_index[type] = index;
+        scheduler->queue[index].type = type;
+        scheduler->queue[index].time = time;
+        sift_up(scheduler, index);
+        return;
+    }
+
+    const uint64_t old_time = scheduler->queue[index].time;
+    scheduler->queue[index].time = time;
+
+    if (time < old_time) {
+        sift_up(scheduler, index);
+    } else {
+        sift_down(scheduler, index);
+    }
+}
+
+void cancel_event(GameBoy *gb, const EventType type) {
+    Scheduler *scheduler = &gb->scheduler;
+    assert(type < EVENT_COUNT);
+
+    const int8_t index = scheduler->queue_index[type];
+
+    if (index != -1) {
+        remove_event(scheduler, index);
+    }
+}
+
+// Fires every event that is due at the current cycle, in chronological order
+void run_events(GameBoy *gb) {
+    Scheduler *scheduler = &gb->scheduler;
+
+    while (scheduler->queue_length > 0 && scheduler->queue[0].time <= scheduler->cycles) {
+        const Event event = scheduler->queue[0];
+        remove_event(scheduler, 0);
+        dispatch_event(gb, event);
+    }
+}
+
+// Time of the next event which can change state visible to the CPU
+// Audio samples only read the channels, they can be dispatched late at their own timestamp
+uint64_t next_sync_time(const GameBoy *gb) {
+    const Scheduler *scheduler = &gb->scheduler;
+    uint64_t time = UINT64_MAX;
+
+    for (uint8_t i = 0; i < scheduler->queue_length; ++i) {
+        const Event *event = &scheduler->queue[i];
+
+        if (event->type != EventAudioSample && event->time < time) {
+            time = event->time;
+        }
+    }
+
+    return time;
+}
+
+static void dispatch_event(GameBoy *gb, const Event event) {
+    switch (event.type) {
+    case EventPPU:
+        update_ppu(gb, event.time);
+        break;
+
+    case EventFrameSequencer:
+        update_frame_sequencer(gb, event.time);
+        break;
+
+    case EventAudioSample:
+        update_audio_sample(gb, event.time);
+        break;
+
+    case EventDMA:
+        update_dma(gb);
+        break;
+
+    case EventFrameEnd:
+        gb->scheduler.is_frame_done = true;
+        schedule_event(gb, EventFrameEnd, event.time + FRAME_CYCLES);
+        break;
+
+    default:
+        ASSERT_NOT_REACHED();
+    }
+}
+
+static void swap_events(Scheduler *scheduler, const uint8_t a, const uint8_t b) {
+    const Event event = scheduler->queue[a];
+    scheduler->queue[a] = scheduler->queue[b];
+    scheduler->queue[b] = event;
+
+    scheduler->queue_index[scheduler->queue[a].type] = a;
+    scheduler->queue_index[scheduler->queue[b].type] = b;
+}
+
+static void sift_up(Scheduler *scheduler, uint8_t index) {
+    while (index > 0) {
+        const uint8_t parent = (index - 1) / 2;
+
+        if (scheduler->queue[parent].time <= scheduler->queue[index].time) {
+            break;
+        }
+
+        swap_events(scheduler, parent, index);
+        index = parent;
+    }
+}
+
+static void sift_down(Scheduler *scheduler, uint8_t index) {
+    for (;;) {
+        const uint8_t left = index * 2 + 1;
+        const uint8_t right = left + 1;
+        uint8_t smallest = index;
+
+        if (left < scheduler->queue_length && scheduler->queue[left].time < scheduler->queue[smallest].time) {
+            smallest = left;
+        }
+
+        if (right < scheduler->queue_length && scheduler->queue[right].time < scheduler->queue[smallest].time) {
+            smallest = right;
+        }
+
+        if (smallest == index) {
+            break;
+        }
+
+        swap_events(scheduler, smallest, index);
+        index = smallest;
+    }
+}
+
+static void remove_event(Scheduler *scheduler, const uint8_t index) {
+    assert(index < scheduler->queue_length);
+
+    const uint8_t last = --scheduler->queue_length;
+    scheduler->queue_index[scheduler->queue[index].type] = -1;
+
+    if (index == last) {
+        return;
+    }
+
+    scheduler->queue[index] = scheduler->queue[last];
+    scheduler->queue_index[scheduler->queue[index].type] = index;
+
+    sift_down(scheduler, index);
+    sift_up(scheduler, index);
+}